@@ -5,8 +5,14 @@ endif
 TYPE = native
 
 COMMIT_HASH = off
+COMPACT_THREATS = off
 DISABLE_NEON_DOTPROD = off
 USE_LIBNUMA = off
+PACKED_CORRHIST = off
+CORRHIST_STATS = off
+RELATIVE_CONTHIST = off
+TIME_CHECK_STATS = off
+SEARCH_STATS = off
 
 # https://stackoverflow.com/a/1825832
 rwildcard = $(foreach d,$(wildcard $(1:=/*)),$(call rwildcard,$d,$2) $(filter $(subst *,%,$2),$d))
@@ -21,7 +27,7 @@ SOURCES := $(call rwildcard,src,*.cpp)
 SOURCES_ALL := $(SOURCES) $(SOURCES_3RDPARTY)
 
 CFLAGS := -std=c11
-CXXFLAGS := -std=c++20 -fconstexpr-steps=2097152
+CXXFLAGS := -std=c++20 -fconstexpr-steps=33554432
 
 CXXFLAGS_PERMUTE := $(CXXFLAGS) -O1 -DNDEBUG
 
@@ -35,11 +41,17 @@ FLAGS_NATIVE := -DSP_NATIVE -march=native
 FLAGS_TUNABLE := -DSP_NATIVE -march=native -DSP_EXTERNAL_TUNE=1
 FLAGS_AVX512 := -DSP_AVX512 -DSP_FAST_PEXT -march=icelake-client -mtune=znver4
 FLAGS_AVX2_BMI2 := -DSP_AVX2_BMI2 -DSP_FAST_PEXT -march=haswell -mtune=znver3
+FLAGS_AVX2_VNNI := -DSP_AVX2_VNNI -DSP_FAST_PEXT -march=alderlake -mtune=alderlake
 FLAGS_ZEN2 := -DSP_ZEN2 -march=bdver4 -mno-tbm -mno-sse4a -mtune=znver2
 FLAGS_ARMV8_4 := -DSP_ARMV8_4 -march=armv8.4-a
 FLAGS_APPLE_M1 := -DSP_ARMV8_4 -mcpu=apple-m1 --target=arm64-apple-macos11
 
 ENGINE_FLAGS_RELEASE := -O3 -flto -DNDEBUG
+ENGINE_FLAGS_DISPATCHER := -O3 -DNDEBUG
+
+# Variants linked into multi builds, matching the release builds.
+# Keep in sync with src/dispatch.cpp, which picks one at startup
+MULTI_VARIANTS := avx512 avx2-bmi2 zen2
 ENGINE_FLAGS_SANITIZER := -O1 -flto -g -fsanitize=address,undefined
 
 ifdef NO_EXE_SET
@@ -97,6 +109,30 @@ ifeq ($(USE_LIBNUMA),on)
 	LDFLAGS += -lnuma
 endif
 
+ifeq ($(COMPACT_THREATS),on)
+    FLAGS += -DSP_COMPACT_THREATS
+endif
+
+ifeq ($(PACKED_CORRHIST),on)
+    FLAGS += -DSP_PACKED_CORRHIST
+endif
+
+ifeq ($(CORRHIST_STATS),on)
+    FLAGS += -DSP_CORRHIST_STATS
+endif
+
+ifeq ($(RELATIVE_CONTHIST),on)
+    FLAGS += -DSP_RELATIVE_CONTHIST
+endif
+
+ifeq ($(TIME_CHECK_STATS),on)
+    FLAGS += -DSP_TIME_CHECK_STATS
+endif
+
+ifeq ($(SEARCH_STATS),on)
+    FLAGS += -DSP_SEARCH_STATS
+endif
+
 OUTFILE = $(subst .exe,,$(EXE))$(SUFFIX)
 
 ifeq ($(TYPE), native)
@@ -114,6 +150,9 @@ else ifeq ($(TYPE), avx512)
 else ifeq ($(TYPE), avx2-bmi2)
     FLAGS += $(FLAGS_AVX2_BMI2)
     ENGINE_FLAGS += $(ENGINE_FLAGS_RELEASE)
+else ifeq ($(TYPE), avx2-vnni)
+    FLAGS += $(FLAGS_AVX2_VNNI)
+    ENGINE_FLAGS += $(ENGINE_FLAGS_RELEASE)
 else ifeq ($(TYPE), zen2)
     FLAGS += $(FLAGS_ZEN2)
     ENGINE_FLAGS += $(ENGINE_FLAGS_RELEASE)
@@ -123,6 +162,11 @@ else ifeq ($(TYPE), armv8-4)
 else ifeq ($(TYPE), apple-m1)
     FLAGS += $(FLAGS_APPLE_M1)
     ENGINE_FLAGS += $(ENGINE_FLAGS_RELEASE)
+else ifeq ($(TYPE), multi)
+    ifneq ($(DETECTED_OS), Linux)
+        $(error Multi-arch builds are only supported on Linux)
+    endif
+    ENGINE_FLAGS += $(ENGINE_FLAGS_DISPATCHER)
 else
     $(error Unknown build type)
 endif
@@ -133,6 +177,14 @@ CFLAGS_ENGINE += $(FLAGS) $(ENGINE_FLAGS)
 CXXFLAGS_ENGINE += $(FLAGS) $(ENGINE_FLAGS)
 
 BUILD_DIR := build-$(TYPE)
+
+# Compiling one variant of a multi build, see below
+ifeq ($(DISPATCH_VARIANT),on)
+    DISPATCH_ENTRY := sp_entry_$(subst -,_,$(TYPE))
+    CFLAGS_ENGINE += -DSP_DISPATCH_ENTRY=$(DISPATCH_ENTRY)
+    CXXFLAGS_ENGINE += -DSP_DISPATCH_ENTRY=$(DISPATCH_ENTRY)
+    BUILD_DIR := build-$(TYPE)-dispatch
+endif
 OBJECTS := $(addprefix $(BUILD_DIR)/,$(filter %.o,$(SOURCES_ALL:.c=.o) $(SOURCES_ALL:.cpp=.o) $(SOURCES_ALL:.cc=.o)))
 
 define create_mkdir_target
@@ -149,6 +201,14 @@ tmp:
 
 EVALFILE_NAME := $(notdir $(EVALFILE))
 
+PERMUTED_NET := tmp/$(EVALFILE_NAME)_permuted_$(TYPE)
+PERMUTE_ARGS :=
+
+ifeq ($(COMPACT_THREATS),on)
+    PERMUTED_NET := $(PERMUTED_NET)_compact
+    PERMUTE_ARGS += --compact-threats
+endif
+
 .DEFAULT_GOAL := $(OUTFILE)
 
 .SECONDEXPANSION:
@@ -156,20 +216,54 @@ EVALFILE_NAME := $(notdir $(EVALFILE))
 tmp/permute-$(TYPE): tmp $(SOURCES_PERMUTE)
 	$(CXX) $(CXXFLAGS_PERMUTE) $(LDFLAGS) -o tmp/permute-$(TYPE) $(filter-out $<,$^)
 
-tmp/$(EVALFILE_NAME)_permuted_$(TYPE): $(EVALFILE) tmp/permute-$(TYPE)
-	tmp/permute-$(TYPE) $< $@
+$(PERMUTED_NET): $(EVALFILE) tmp/permute-$(TYPE)
+	tmp/permute-$(TYPE) $< $@ $(PERMUTE_ARGS)
+
+$(BUILD_DIR)/%.o: %.c version.txt $(PERMUTED_NET) | $$(@D)/
+	$(CC) $(CFLAGS_ENGINE) -DSP_NETWORK_FILE=\"$(PERMUTED_NET)\" -c -o $@ $<
+
+$(BUILD_DIR)/%.o: %.cpp version.txt $(PERMUTED_NET) | $$(@D)/
+	$(CXX) $(CXXFLAGS_ENGINE) -DSP_NETWORK_FILE=\"$(PERMUTED_NET)\" -c -o $@ $<
 
-$(BUILD_DIR)/%.o: %.c version.txt tmp/$(EVALFILE_NAME)_permuted_$(TYPE) | $$(@D)/
-	$(CC) $(CFLAGS_ENGINE) -DSP_NETWORK_FILE=\"tmp/$(EVALFILE_NAME)_permuted_$(TYPE)\" -c -o $@ $<
+$(BUILD_DIR)/%.o: %.cc version.txt $(PERMUTED_NET) | $$(@D)/
+	$(CXX) $(CXXFLAGS_ENGINE) -DSP_NETWORK_FILE=\"$(PERMUTED_NET)\" -c -o $@ $<
 
-$(BUILD_DIR)/%.o: %.cpp version.txt tmp/$(EVALFILE_NAME)_permuted_$(TYPE) | $$(@D)/
-	$(CXX) $(CXXFLAGS_ENGINE) -DSP_NETWORK_FILE=\"tmp/$(EVALFILE_NAME)_permuted_$(TYPE)\" -c -o $@ $<
+ifeq ($(TYPE), multi)
+# Each variant is a full build of the engine, partially linked (with LTO) into a single object
+# that only exports its entry point. Everything else, including inline functions and template
+# instantiations, stays private to the variant, so code compiled for one instruction set can
+# never be picked up by another. Only the dispatcher is compiled for baseline x86-64
+MULTI_OBJECTS := $(foreach variant,$(MULTI_VARIANTS),build-$(variant)-dispatch/variant.o)
+DISPATCH_OBJECTS := $(BUILD_DIR)/src/dispatch.o $(BUILD_DIR)/3rdparty/fmt/src/format.o
 
-$(BUILD_DIR)/%.o: %.cc version.txt tmp/$(EVALFILE_NAME)_permuted_$(TYPE) | $$(@D)/
-	$(CXX) $(CXXFLAGS_ENGINE) -DSP_NETWORK_FILE=\"tmp/$(EVALFILE_NAME)_permuted_$(TYPE)\" -c -o $@ $<
+.PHONY: FORCE
+FORCE:
 
+build-%-dispatch/variant.o: FORCE
+	$(MAKE) -f build.mk TYPE=$* DISPATCH_VARIANT=on $@
+
+$(BUILD_DIR)/src/dispatch.o: src/dispatch.cpp version.txt | $$(@D)/
+	$(CXX) $(CXXFLAGS_ENGINE) -DSP_DISPATCH -c -o $@ $<
+
+$(BUILD_DIR)/3rdparty/fmt/src/format.o: 3rdparty/fmt/src/format.cc | $$(@D)/
+	$(CXX) $(CXXFLAGS_ENGINE) -c -o $@ $<
+
+$(OUTFILE): $(DISPATCH_OBJECTS) $(MULTI_OBJECTS)
+	$(CXX) $(CXXFLAGS_ENGINE) $(LDFLAGS) -o $(OUTFILE) $(DISPATCH_OBJECTS) $(MULTI_OBJECTS)
+else
 $(OUTFILE): $(OBJECTS)
 	$(CXX) $(CXXFLAGS_ENGINE) $(LDFLAGS) -o $(OUTFILE) $(OBJECTS)
+endif
+
+ifeq ($(DISPATCH_VARIANT),on)
+$(BUILD_DIR)/variant.o: $(OBJECTS)
+	$(CXX) $(CXXFLAGS_ENGINE) -r -nostdlib -fuse-ld=lld -o $@.partial $(OBJECTS)
+	$(OBJCOPY) --keep-global-symbol=$(DISPATCH_ENTRY) $@.partial $@
+	@$(OBJDUMP) -d --no-show-raw-insn $@ | awk '\
+		/^[0-9a-f]+ <.*>:$$/ { init = $$0 ~ /_GLOBAL__sub_I|__cxx_global_var_init/; name = $$2; next } \
+		init && $$2 ~ /^v/ { print "$@: " name " runs before dispatch but uses " $$2; bad = 1 } \
+		END { exit bad }' || (rm -f $@ && echo "static initialisers must not use instructions the dispatcher has not checked for" && false)
+endif
 
 bench: $(OUTFILE)
 	./$(OUTFILE) bench
@@ -18,14 +18,25 @@
 
 #include "../src/types.h"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
 #include <fstream>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
+#include "../src/eval/activations.h"
 #include "../src/eval/arch.h"
 #include "../src/eval/header.h"
 #include "../src/util/multi_array.h"
+#include "../src/util/simd.h"
 
 using namespace stormphrax;
 using namespace stormphrax::eval;
@@ -55,12 +66,346 @@ struct LoadedNetwork {
     std::array<i32, OutputBucketing::kBucketCount> l3Biases;
 };
 
+namespace {
+    constexpr u32 kPairCount = kL1Size / 2;
+    // the sparse L1 skips 4-byte chunks of FT outputs
+    constexpr u32 kChunkNeurons = sizeof(i32) / sizeof(u8);
+
+    static_assert(kPairCount % kChunkNeurons == 0);
+
+    struct Activations {
+        usize samples{};
+        usize words{};
+        // one bitset over all samples per neuron
+        std::vector<u64> columns{};
+
+        [[nodiscard]] inline std::span<const u64> column(u32 neuron) const {
+            return std::span{columns}.subspan(neuron * words, words);
+        }
+    };
+
+    std::optional<Activations> loadActivations(const char* path) {
+        std::ifstream in{path, std::ios::binary};
+        if (!in) {
+            eprintln("Failed to open activation file \"{}\"", path);
+            return {};
+        }
+
+        ActivationDumpHeader header{};
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            eprintln("Failed to read activation file header");
+            return {};
+        }
+
+        if (header.magic != kActivationDumpMagic) {
+            eprintln("Invalid activation file magic");
+            return {};
+        }
+
+        if (header.version != kActivationDumpVersion) {
+            eprintln("Unsupported activation file version {}", static_cast<u32>(header.version));
+            return {};
+        }
+
+        if (header.neurons != kPairCount) {
+            eprintln("Activation file has {} neurons, expected {}", static_cast<u32>(header.neurons), kPairCount);
+            return {};
+        }
+
+        if (header.samples == 0) {
+            eprintln("Activation file is empty");
+            return {};
+        }
+
+        Activations activations{};
+
+        activations.samples = header.samples;
+        activations.words = (header.samples + 63) / 64;
+        activations.columns.resize(kPairCount * activations.words);
+
+        std::array<u8, kPairCount / 8> sample{};
+
+        for (usize sampleIdx = 0; sampleIdx < header.samples; ++sampleIdx) {
+            if (!in.read(reinterpret_cast<char*>(sample.data()), sample.size())) {
+                eprintln("Failed to read activation sample {}", sampleIdx);
+                return {};
+            }
+
+            const auto word = sampleIdx / 64;
+            const auto bit = u64{1} << (sampleIdx % 64);
+
+            for (u32 neuron = 0; neuron < kPairCount; ++neuron) {
+                if (sample[neuron / 8] & (1 << (neuron % 8))) {
+                    activations.columns[neuron * activations.words + word] |= bit;
+                }
+            }
+        }
+
+        return activations;
+    }
+
+    [[nodiscard]] usize activeSamples(std::span<const u64> bits) {
+        usize count{};
+
+        for (const auto word : bits) {
+            count += std::popcount(word);
+        }
+
+        return count;
+    }
+
+    // Total number of nonzero chunks over all samples, if neuron order[i] is placed at index i
+    [[nodiscard]] usize nonzeroChunks(const Activations& activations, std::span<const u32> order) {
+        std::vector<u64> mask(activations.words);
+        usize count{};
+
+        for (u32 chunk = 0; chunk < kPairCount; chunk += kChunkNeurons) {
+            std::ranges::fill(mask, 0);
+
+            for (u32 i = chunk; i < chunk + kChunkNeurons; ++i) {
+                const auto column = activations.column(order[i]);
+                for (usize word = 0; word < activations.words; ++word) {
+                    mask[word] |= column[word];
+                }
+            }
+
+            count += activeSamples(mask);
+        }
+
+        return count;
+    }
+
+    // Greedily fills each chunk, starting from the least active remaining neuron and then
+    // repeatedly adding whichever neuron least increases the number of samples in which
+    // the chunk is nonzero. Neurons that tend to fire together end up sharing chunks, and
+    // rarely active ones are grouped into chunks that the sparse L1 can usually skip
+    [[nodiscard]] std::vector<u32> computeNeuronOrder(const Activations& activations) {
+        std::vector<usize> frequencies(kPairCount);
+        for (u32 neuron = 0; neuron < kPairCount; ++neuron) {
+            frequencies[neuron] = activeSamples(activations.column(neuron));
+        }
+
+        std::vector<u32> order{};
+        order.reserve(kPairCount);
+
+        std::vector<bool> used(kPairCount);
+
+        std::vector<u64> mask(activations.words);
+        std::vector<u64> candidate(activations.words);
+
+        const auto take = [&](u32 neuron) {
+            const auto column = activations.column(neuron);
+            for (usize word = 0; word < activations.words; ++word) {
+                mask[word] |= column[word];
+            }
+
+            used[neuron] = true;
+            order.push_back(neuron);
+        };
+
+        while (order.size() < kPairCount) {
+            std::ranges::fill(mask, 0);
+
+            u32 seed = kPairCount;
+            for (u32 neuron = 0; neuron < kPairCount; ++neuron) {
+                if (!used[neuron] && (seed == kPairCount || frequencies[neuron] < frequencies[seed])) {
+                    seed = neuron;
+                }
+            }
+
+            take(seed);
+
+            for (u32 i = 1; i < kChunkNeurons; ++i) {
+                u32 best = kPairCount;
+                usize bestActive = std::numeric_limits<usize>::max();
+
+                for (u32 neuron = 0; neuron < kPairCount; ++neuron) {
+                    if (used[neuron]) {
+                        continue;
+                    }
+
+                    const auto column = activations.column(neuron);
+                    for (usize word = 0; word < activations.words; ++word) {
+                        candidate[word] = mask[word] | column[word];
+                    }
+
+                    const auto active = activeSamples(candidate);
+
+                    if (active < bestActive
+                        || (active == bestActive && frequencies[neuron] < frequencies[best]))
+                    {
+                        best = neuron;
+                        bestActive = active;
+                    }
+                }
+
+                take(best);
+            }
+        }
+
+        return order;
+    }
+
+    // Moves neuron order[i] to index i. The FT output for neuron i is the product of
+    // accumulator values i and i + kPairCount, so both halves of the FT move together,
+    // and the L1 inputs for both perspectives are reordered to match
+    void reorderNeurons(LoadedNetwork& network, std::span<const u32> order) {
+        const auto reorderFt = [&]<typename T>(std::span<T> values) {
+            std::array<T, kL1Size> tmp{};
+
+            for (usize offset = 0; offset < values.size(); offset += kL1Size) {
+                std::copy(&values[offset], &values[offset] + kL1Size, tmp.begin());
+
+                for (u32 i = 0; i < kPairCount; ++i) {
+                    values[offset + i] = tmp[order[i]];
+                    values[offset + kPairCount + i] = tmp[kPairCount + order[i]];
+                }
+            }
+        };
+
+        reorderFt(std::span<i16>{network.ftWeights.psq});
+        reorderFt(std::span<i16>{network.ftBiases});
+
+        if constexpr (InputFeatureSet::kThreatInputs) {
+            reorderFt(std::span<i8>{network.ftWeights.threat});
+        }
+
+        // L1 weights are stored as [bucket][input chunk][output][input within chunk]
+        const auto l1WeightIdx = [](u32 input, u32 output) {
+            return (input / kChunkNeurons) * kChunkNeurons * kL2Size + output * kChunkNeurons + input % kChunkNeurons;
+        };
+
+        std::array<i8, kL1Size * kL2Size> tmp{};
+
+        for (u32 bucket = 0; bucket < OutputBucketing::kBucketCount; ++bucket) {
+            auto* weights = &network.l1Weights[bucket * kL1Size * kL2Size];
+            std::copy(weights, weights + tmp.size(), tmp.begin());
+
+            for (u32 input = 0; input < kL1Size; ++input) {
+                const auto half = input / kPairCount;
+                const auto src = half * kPairCount + order[input % kPairCount];
+
+                for (u32 output = 0; output < kL2Size; ++output) {
+                    weights[l1WeightIdx(input, output)] = tmp[l1WeightIdx(src, output)];
+                }
+            }
+        }
+    }
+
+    struct CompactThreatWeights {
+        std::vector<i8> weights{};
+        std::vector<i16> scales{};
+    };
+
+    // Quantises each (already permuted) threat row to 4 bits with a per-row scale,
+    // and packs pairs of SIMD chunks as described at NetworkFlags::kCompactThreats
+    [[nodiscard]] CompactThreatWeights compactThreats(std::span<const i8> threatWeights) {
+        static constexpr usize kChunk = util::simd::kChunkSize<i16>;
+        static constexpr usize kFeatureCount = InputFeatureSet::kThreatFeatures;
+
+        static_assert(kL1Size % (kChunk * 2) == 0);
+
+        CompactThreatWeights result{};
+
+        result.weights.resize(kFeatureCount * kL1Size / 2);
+        result.scales.resize(compactThreatScaleCount(kFeatureCount));
+
+        usize exactRows{};
+
+        f64 totalError{};
+        i32 maxError{};
+
+        std::array<i32, kL1Size> quantised{};
+
+        for (usize feature = 0; feature < kFeatureCount; ++feature) {
+            const auto row = threatWeights.subspan(feature * kL1Size, kL1Size);
+
+            i32 maxAbs = 0;
+            for (const auto weight : row) {
+                maxAbs = std::max(maxAbs, std::abs(static_cast<i32>(weight)));
+            }
+
+            const auto scale = std::max((maxAbs + 6) / 7, 1);
+            bool exact = true;
+
+            for (usize i = 0; i < kL1Size; ++i) {
+                const auto weight = static_cast<i32>(row[i]);
+                const auto q = std::clamp(
+                    static_cast<i32>(std::lround(static_cast<f64>(weight) / static_cast<f64>(scale))),
+                    -8,
+                    7
+                );
+
+                const auto error = std::abs(q * scale - weight);
+
+                totalError += static_cast<f64>(error);
+                maxError = std::max(maxError, error);
+
+                if (error != 0) {
+                    exact = false;
+                }
+
+                quantised[i] = q;
+            }
+
+            if (exact) {
+                ++exactRows;
+            }
+
+            result.scales[feature] = static_cast<i16>(scale);
+
+            auto* packed = &result.weights[feature * kL1Size / 2];
+
+            for (usize pair = 0; pair < kL1Size / (kChunk * 2); ++pair) {
+                for (usize i = 0; i < kChunk; ++i) {
+                    const auto lo = quantised[pair * kChunk * 2 + i];
+                    const auto hi = quantised[pair * kChunk * 2 + kChunk + i];
+                    packed[pair * kChunk + i] = static_cast<i8>(static_cast<u8>((lo & 0xF) | ((hi & 0xF) << 4)));
+                }
+            }
+        }
+
+        println(
+            "Compacted {} threat rows, {} exact, mean abs error {:.4f}, max abs error {}",
+            kFeatureCount,
+            exactRows,
+            totalError / static_cast<f64>(kFeatureCount * kL1Size),
+            maxError
+        );
+
+        return result;
+    }
+} // namespace
+
 i32 main(i32 argc, char* argv[]) {
-    if (argc < 3) {
-        eprintln("usage: {} <input net> <output net>", argv[0]);
+    if (argc < 3 || argc > 4) {
+        eprintln("usage: {} <input net> <output net> [activations | --compact-threats]", argv[0]);
+        eprintln("  with an activation file from \"evalbench activations\", reorders FT neurons to");
+        eprintln("  improve L1 sparsity and writes a portable network without SIMD-specific permutation");
+        eprintln("  with --compact-threats, additionally quantises threat weights to 4 bits with a");
+        eprintln("  scale per feature, halving their size at some cost in accuracy");
         return 1;
     }
 
+    std::optional<Activations> activations{};
+    bool compact = false;
+
+    if (argc > 3) {
+        if (std::string_view{argv[3]} == "--compact-threats") {
+            if constexpr (!InputFeatureSet::kThreatInputs) {
+                eprintln("Current network arch has no threat inputs to compact");
+                return 1;
+            }
+
+            compact = true;
+        } else {
+            activations = loadActivations(argv[3]);
+            if (!activations) {
+                return 1;
+            }
+        }
+    }
+
     std::ifstream in{argv[1], std::ios::binary};
     if (!in) {
         eprintln("Failed to open input file \"{}\"", argv[1]);
@@ -84,12 +429,31 @@ i32 main(i32 argc, char* argv[]) {
         return 1;
     }
 
+    if (testFlags(header.flags, NetworkFlags::kCompactThreats)) {
+        eprintln("Network already has compact threat weights");
+        return 1;
+    }
+
+    if (compact) {
+        if (testFlags(header.flags, NetworkFlags::kZstdCompressed)) {
+            eprintln("Cannot compact threat weights in a compressed network");
+            return 1;
+        }
+
+        header.flags = header.flags | NetworkFlags::kCompactThreats;
+    }
+
     if (!out.write(reinterpret_cast<const char*>(&header), sizeof(header))) {
         eprintln("Failed to write header");
         return 1;
     }
 
     if (testFlags(header.flags, NetworkFlags::kZstdCompressed)) {
+        if (activations) {
+            eprintln("Cannot reorder neurons in a compressed network");
+            return 1;
+        }
+
         println("Compressed network, skipping permutation");
         std::copy(std::istreambuf_iterator{in}, std::istreambuf_iterator<char>{}, std::ostreambuf_iterator{out});
         if (!out) {
@@ -99,7 +463,7 @@ i32 main(i32 argc, char* argv[]) {
         return 0;
     }
 
-    if constexpr (!LayeredArch::kRequiresFtPermute) {
+    if (!activations && !compact && !LayeredArch::kRequiresFtPermute) {
         println("No permutation required for current network arch");
         std::copy(std::istreambuf_iterator{in}, std::istreambuf_iterator<char>{}, std::ostreambuf_iterator{out});
         if (!out) {
@@ -116,16 +480,64 @@ i32 main(i32 argc, char* argv[]) {
         return 1;
     }
 
-    println("Permuting network");
+    if (activations) {
+        println("Reordering FT neurons from {} activation samples", activations->samples);
 
-    LayeredArch::permuteParams<i16>(network->ftWeights.psq);
-    LayeredArch::permuteParams<i16>(network->ftBiases);
+        std::vector<u32> identity(kPairCount);
+        for (u32 i = 0; i < kPairCount; ++i) {
+            identity[i] = i;
+        }
+
+        const auto order = computeNeuronOrder(*activations);
+
+        const auto totalChunks = static_cast<f64>(activations->samples * (kPairCount / kChunkNeurons));
+
+        println(
+            "Nonzero L1 input chunks: {:.2f}% -> {:.2f}%",
+            static_cast<f64>(nonzeroChunks(*activations, identity)) * 100.0 / totalChunks,
+            static_cast<f64>(nonzeroChunks(*activations, order)) * 100.0 / totalChunks
+        );
 
-    if constexpr (InputFeatureSet::kThreatInputs) {
-        LayeredArch::permuteParams<i8>(network->ftWeights.threat);
+        reorderNeurons(*network, order);
+
+        if (!out.write(reinterpret_cast<const char*>(network.get()), sizeof(LoadedNetwork))) {
+            eprintln("Failed to write network");
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if constexpr (LayeredArch::kRequiresFtPermute) {
+        println("Permuting network");
+
+        LayeredArch::permuteParams<i16>(network->ftWeights.psq);
+        LayeredArch::permuteParams<i16>(network->ftBiases);
+
+        if constexpr (InputFeatureSet::kThreatInputs) {
+            LayeredArch::permuteParams<i8>(network->ftWeights.threat);
+        }
+    }
+
+    if (!compact) {
+        if (!out.write(reinterpret_cast<const char*>(network.get()), sizeof(LoadedNetwork))) {
+            eprintln("Failed to write network");
+            return 1;
+        }
+
+        return 0;
     }
 
-    if (!out.write(reinterpret_cast<const char*>(network.get()), sizeof(LoadedNetwork))) {
+    const auto compacted = compactThreats(network->ftWeights.threat);
+
+    const auto* rest = reinterpret_cast<const char*>(&network->ftBiases);
+    const auto restSize = sizeof(LoadedNetwork) - offsetof(LoadedNetwork, ftBiases);
+
+    if (!out.write(reinterpret_cast<const char*>(&network->ftWeights.psq), sizeof(network->ftWeights.psq))
+        || !out.write(reinterpret_cast<const char*>(compacted.weights.data()), compacted.weights.size())
+        || !out.write(reinterpret_cast<const char*>(compacted.scales.data()), compacted.scales.size() * sizeof(i16))
+        || !out.write(rest, static_cast<std::streamsize>(restSize)))
+    {
         eprintln("Failed to write network");
         return 1;
     }
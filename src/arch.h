@@ -40,7 +40,7 @@
         #define SP_HAS_VBMI 0
         #define SP_HAS_AVX512 0
     #endif
-    #define SP_HAS_VNNI256 0 // slowdown on any cpu that would use it
+    #define SP_HAS_VNNI256 0 // unmeasured, only enabled by the opt-in avx2-vnni build
     #define SP_HAS_AVX2 __AVX2__
     #define SP_HAS_NEON __ARM_NEON
     #if !defined(SP_DISABLE_NEON_DOTPROD)
@@ -68,6 +68,16 @@
     #define SP_HAS_AVX2 1
     #define SP_HAS_NEON 0
     #define SP_HAS_NEON_DOTPROD 0
+#elif defined(SP_AVX2_VNNI)
+    #define SP_HAS_BMI2 1
+    #define SP_HAS_VNNI512 0
+    #define SP_HAS_VBMI2 0
+    #define SP_HAS_VBMI 0
+    #define SP_HAS_AVX512 0
+    #define SP_HAS_VNNI256 1
+    #define SP_HAS_AVX2 1
+    #define SP_HAS_NEON 0
+    #define SP_HAS_NEON_DOTPROD 0
 #elif defined(SP_ZEN2)
     #define SP_HAS_BMI2 0
     #define SP_HAS_VNNI512 0
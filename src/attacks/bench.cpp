@@ -0,0 +1,128 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include <array>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "../util/rng.h"
+#include "../util/timer.h"
+#include "attacks.h"
+
+namespace stormphrax::attacks::bench {
+    using util::Instant;
+
+    namespace {
+        constexpr u64 kSeed = 0xA77AC5;
+
+        constexpr usize kInputCount = 65536;
+        constexpr usize kRepetitions = 256;
+
+        struct Input {
+            Square sq;
+            Bitboard occ;
+        };
+
+        struct Result {
+            f64 latency;
+            f64 throughput;
+            u64 checksum;
+        };
+
+        template <typename Lookup>
+        Result measure(std::span<const Input> inputs, Lookup lookup) {
+            const auto ops = static_cast<f64>(inputs.size() * kRepetitions);
+
+            Result result{};
+
+            // each lookup's occupancy depends on the previous result, so lookups cannot overlap
+            auto start = Instant::now();
+
+            Bitboard prev{};
+
+            for (usize rep = 0; rep < kRepetitions; ++rep) {
+                for (const auto [sq, occ] : inputs) {
+                    prev = lookup(sq, occ ^ (prev & Bitboard{1}));
+                }
+            }
+
+            result.latency = start.elapsed() * 1000000000.0 / ops;
+            result.checksum = prev;
+
+            start = Instant::now();
+
+            u64 checksum{};
+
+            for (usize rep = 0; rep < kRepetitions; ++rep) {
+                for (const auto [sq, occ] : inputs) {
+                    checksum ^= lookup(sq, occ);
+                }
+            }
+
+            result.throughput = start.elapsed() * 1000000000.0 / ops;
+            result.checksum ^= checksum;
+
+            return result;
+        }
+    } // namespace
+
+    void run() {
+        util::rng::Jsf64Rng rng{kSeed};
+
+        auto inputs = std::make_unique<std::array<Input, kInputCount>>();
+
+        for (auto& input : *inputs) {
+            input.sq = Square::fromRaw(rng.nextU32(Squares::kCount));
+            // roughly middlegame occupancy density
+            input.occ = rng.nextU64() & rng.nextU64() & ~input.sq.bit();
+        }
+
+        const auto print = [](std::string_view name, const Result& result) {
+            println("{:<28} {:>10.2f} {:>10.2f}", name, result.latency, result.throughput);
+        };
+
+        const auto rook = measure(*inputs, [](Square sq, Bitboard occ) { return getRookAttacks(sq, occ); });
+        const auto bishop = measure(*inputs, [](Square sq, Bitboard occ) { return getBishopAttacks(sq, occ); });
+        const auto queen = measure(*inputs, [](Square sq, Bitboard occ) { return getQueenAttacks(sq, occ); });
+
+        const auto rookRays = measure(*inputs, [](Square sq, Bitboard occ) { return genRookAttacks(sq, occ); });
+        const auto bishopRays = measure(*inputs, [](Square sq, Bitboard occ) { return genBishopAttacks(sq, occ); });
+
+        println("slider backend {}", lookup::kBackendName);
+        println("{} lookups x {} repetitions", kInputCount, kRepetitions);
+        println();
+
+        println("{:<28} {:>10} {:>10}", "lookup", "latency", "throughput");
+        println("{:<28} {:>10} {:>10}", "", "ns/op", "ns/op");
+
+        print("rook", rook);
+        print("bishop", bishop);
+        print("queen", queen);
+        print("rook (ray walk)", rookRays);
+        print("bishop (ray walk)", bishopRays);
+
+        println();
+        println(
+            "checksum {}",
+            rook.checksum ^ bishop.checksum ^ queen.checksum ^ rookRays.checksum ^ bishopRays.checksum
+        );
+    }
+} // namespace stormphrax::attacks::bench
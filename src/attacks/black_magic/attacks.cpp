@@ -23,62 +23,95 @@ namespace stormphrax::attacks::lookup {
     using namespace black_magic;
 
     namespace {
-        std::array<Bitboard, kRookData.tableSize> generateRookAttacks() {
+        constexpr auto kLines = internal::generateLineAttacks();
+
+        // Spreads a byte over file A, with bit n going to rank n
+        constexpr auto kFileFromByte = [] {
+            std::array<u64, 256> dst{};
+
+            for (u32 byte = 0; byte < 256; ++byte) {
+                for (i32 rank = 0; rank < 8; ++rank) {
+                    if (byte & (1U << rank)) {
+                        dst[byte] |= u64{1} << (rank * 8);
+                    }
+                }
+            }
+
+            return dst;
+        }();
+
+        // Equivalent to the four orthogonal generateSlidingAttacks calls
+        consteval u64 rookAttacksFromLines(i32 file, i32 rank, u64 occ) {
+            const auto rankAttacks = static_cast<u64>(kLines[file][internal::rankOccupancy(occ, rank)]);
+            const auto fileAttacks = kFileFromByte[kLines[rank][internal::fileOccupancy(occ, file)]];
+
+            return (rankAttacks << (rank * 8)) | (fileAttacks << file);
+        }
+
+        // Occupancies are enumerated with the carry-rippler trick, and rook attacks are built
+        // from line lookups, to keep the number of constant evaluation steps down. Black
+        // magics allow constructive collisions, so entries that are already filled are skipped
+        consteval std::array<Bitboard, kRookData.tableSize> generateRookAttacks() {
             std::array<Bitboard, kRookData.tableSize> dst{};
 
             for (u32 sq = 0; sq < Squares::kCount; ++sq) {
                 const auto& data = kRookData.data[sq];
 
-                const auto invMask = ~data.mask;
-                const auto maxEntries = 1 << invMask.popcount();
+                const auto mask = static_cast<u64>(data.mask);
+                const auto invMask = ~mask;
 
-                for (u32 i = 0; i < maxEntries; ++i) {
-                    const auto occ = util::pdep(i, invMask);
-                    const auto idx = getRookIdx(occ, Square::fromRaw(sq));
+                const auto magic = kRookMagics[sq];
+                const auto shift = kRookShifts[sq];
 
-                    if (!dst[data.offset + idx].empty()) {
-                        continue;
-                    }
+                const auto file = Square::fromRaw(sq).file();
+                const auto rank = Square::fromRaw(sq).rank();
+
+                u64 occ{};
 
-                    for (const auto dir : {offsets::kUp, offsets::kDown, offsets::kLeft, offsets::kRight}) {
-                        dst[data.offset + idx] |= internal::generateSlidingAttacks(Square::fromRaw(sq), dir, occ);
+                do {
+                    // getRookIdx, without the Bitboard wrappers
+                    auto& attacks = dst[data.offset + (((occ | mask) * magic) >> shift)];
+
+                    if (attacks.empty()) {
+                        attacks = rookAttacksFromLines(file, rank, occ);
                     }
-                }
+
+                    occ = (occ - invMask) & invMask;
+                } while (occ != 0);
             }
 
             return dst;
         }
 
-        std::array<Bitboard, kBishopData.tableSize> generateBishopAttacks() {
+        consteval std::array<Bitboard, kBishopData.tableSize> generateBishopAttacks() {
             std::array<Bitboard, kBishopData.tableSize> dst{};
 
-            for (u32 square = 0; square < Squares::kCount; ++square) {
-                const auto& data = kBishopData.data[square];
+            for (u32 sq = 0; sq < Squares::kCount; ++sq) {
+                const auto& data = kBishopData.data[sq];
+                const auto invMask = static_cast<u64>(~data.mask);
 
-                const auto invMask = ~data.mask;
-                const auto maxEntries = 1 << invMask.popcount();
+                u64 occ{};
 
-                for (u32 i = 0; i < maxEntries; ++i) {
-                    const auto occ = util::pdep(i, invMask);
-                    const auto idx = getBishopIdx(occ, Square::fromRaw(square));
+                do {
+                    auto& attacks = dst[data.offset + getBishopIdx(occ, Square::fromRaw(sq))];
 
-                    if (!dst[data.offset + idx].empty()) {
-                        continue;
+                    if (attacks.empty()) {
+                        for (const auto dir :
+                             {offsets::kUpLeft, offsets::kUpRight, offsets::kDownLeft, offsets::kDownRight})
+                        {
+                            attacks |= internal::generateSlidingAttacks(Square::fromRaw(sq), dir, occ);
+                        }
                     }
 
-                    for (const auto dir :
-                         {offsets::kUpLeft, offsets::kUpRight, offsets::kDownLeft, offsets::kDownRight})
-                    {
-                        dst[data.offset + idx] |= internal::generateSlidingAttacks(Square::fromRaw(square), dir, occ);
-                    }
-                }
+                    occ = (occ - invMask) & invMask;
+                } while (occ != 0);
             }
 
             return dst;
         }
     } // namespace
 
-    const std::array<Bitboard, kRookData.tableSize> g_rookAttacks = generateRookAttacks();
-    const std::array<Bitboard, kBishopData.tableSize> g_bishopAttacks = generateBishopAttacks();
+    alignas(64) constexpr std::array<Bitboard, kRookData.tableSize> g_rookAttacks = generateRookAttacks();
+    alignas(64) constexpr std::array<Bitboard, kBishopData.tableSize> g_bishopAttacks = generateBishopAttacks();
 } // namespace stormphrax::attacks::lookup
 #endif // !SP_HAS_BMI2
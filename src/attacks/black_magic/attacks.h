@@ -21,6 +21,7 @@
 #include "../../types.h"
 
 #include <array>
+#include <string_view>
 
 #include "../../bitboard.h"
 #include "../../core.h"
@@ -29,10 +30,13 @@
 #include "data.h"
 
 namespace stormphrax::attacks::lookup {
+    constexpr std::string_view kBackendName = "black magic";
+
+    // Generated at compile time
     extern const std::array<Bitboard, black_magic::kRookData.tableSize> g_rookAttacks;
     extern const std::array<Bitboard, black_magic::kBishopData.tableSize> g_bishopAttacks;
 
-    [[nodiscard]] inline usize getRookIdx(Bitboard occ, Square src) {
+    [[nodiscard]] constexpr usize getRookIdx(Bitboard occ, Square src) {
         const auto s = src.idx();
 
         const auto& data = black_magic::kRookData.data[s];
@@ -43,7 +47,7 @@ namespace stormphrax::attacks::lookup {
         return ((occ | data.mask) * magic) >> shift;
     }
 
-    [[nodiscard]] inline usize getBishopIdx(Bitboard occ, Square src) {
+    [[nodiscard]] constexpr usize getBishopIdx(Bitboard occ, Square src) {
         const auto s = src.idx();
 
         const auto& data = black_magic::kBishopData.data[s];
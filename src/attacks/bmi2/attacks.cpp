@@ -23,52 +23,71 @@ namespace stormphrax::attacks::lookup {
     using namespace bmi2;
 
     namespace {
-        std::array<u16, kRookData.tableSize> generateRookAttacks() {
+        constexpr auto kLines = internal::generateLineAttacks();
+
+        // Occupancies are enumerated with the carry-rippler trick, which visits the subsets
+        // of a mask in the same order as pdep of increasing indices, and rook attacks are
+        // built from line lookups, to keep the number of constant evaluation steps down
+        consteval std::array<u16, kRookData.tableSize> generateRookAttacks() {
             std::array<u16, kRookData.tableSize> dst{};
 
             for (u32 sq = 0; sq < Squares::kCount; ++sq) {
                 const auto& data = kRookData.data[sq];
-                const auto entries = 1 << data.srcMask.popcount();
+                const auto mask = static_cast<u64>(data.srcMask);
 
-                for (u32 i = 0; i < entries; ++i) {
-                    const auto occ = util::pdep(i, data.srcMask);
+                u64 occ{};
+                u32 i{};
 
-                    Bitboard attacks{};
+                const auto file = Square::fromRaw(sq).file();
+                const auto rank = Square::fromRaw(sq).rank();
 
-                    for (const auto dir : {offsets::kUp, offsets::kDown, offsets::kLeft, offsets::kRight}) {
-                        attacks |= internal::generateSlidingAttacks(Square::fromRaw(sq), dir, occ);
-                    }
+                do {
+                    const u32 rankAttacks = kLines[file][internal::rankOccupancy(occ, rank)];
+                    const u32 fileAttacks = kLines[rank][internal::fileOccupancy(occ, file)];
+
+                    // equivalent to pext(attacks, dstMask): the file below the rook,
+                    // then the rook's rank without the rook, then the file above it
+                    const auto below = fileAttacks & ((1U << rank) - 1);
+                    const auto across = (rankAttacks & ((1U << file) - 1)) | ((rankAttacks >> (file + 1)) << file);
+                    const auto above = fileAttacks >> (rank + 1);
 
-                    dst[data.offset + i] = static_cast<u16>(util::pext(attacks, data.dstMask));
-                }
+                    dst[data.offset + i++] = static_cast<u16>(below | (across << rank) | (above << (rank + 7)));
+
+                    occ = (occ - mask) & mask;
+                } while (occ != 0);
             }
 
             return dst;
         }
 
-        std::array<Bitboard, kBishopData.tableSize> generateBishopAttacks() {
+        consteval std::array<Bitboard, kBishopData.tableSize> generateBishopAttacks() {
             std::array<Bitboard, kBishopData.tableSize> dst{};
 
             for (u32 sq = 0; sq < Squares::kCount; ++sq) {
                 const auto& data = kBishopData.data[sq];
-                const auto entries = 1 << data.mask.popcount();
+                const auto mask = static_cast<u64>(data.mask);
+
+                u64 occ{};
+                u32 i{};
 
-                for (u32 i = 0; i < entries; ++i) {
-                    const auto occ = util::pdep(i, data.mask);
+                do {
+                    auto& attacks = dst[data.offset + i++];
 
                     for (const auto dir :
                          {offsets::kUpLeft, offsets::kUpRight, offsets::kDownLeft, offsets::kDownRight})
                     {
-                        dst[data.offset + i] |= internal::generateSlidingAttacks(Square::fromRaw(sq), dir, occ);
+                        attacks |= internal::generateSlidingAttacks(Square::fromRaw(sq), dir, occ);
                     }
-                }
+
+                    occ = (occ - mask) & mask;
+                } while (occ != 0);
             }
 
             return dst;
         }
     } // namespace
 
-    const std::array<u16, kRookData.tableSize> g_rookAttacks = generateRookAttacks();
-    const std::array<Bitboard, kBishopData.tableSize> g_bishopAttacks = generateBishopAttacks();
+    alignas(64) constexpr std::array<u16, kRookData.tableSize> g_rookAttacks = generateRookAttacks();
+    alignas(64) constexpr std::array<Bitboard, kBishopData.tableSize> g_bishopAttacks = generateBishopAttacks();
 } // namespace stormphrax::attacks::lookup
 #endif // SP_HAS_BMI2
@@ -21,6 +21,7 @@
 #include "../../types.h"
 
 #include <array>
+#include <string_view>
 
 #include "../../bitboard.h"
 #include "../../core.h"
@@ -29,6 +30,9 @@
 #include "data.h"
 
 namespace stormphrax::attacks::lookup {
+    constexpr std::string_view kBackendName = "bmi2";
+
+    // Generated at compile time
     extern const std::array<u16, bmi2::kRookData.tableSize> g_rookAttacks;
     extern const std::array<Bitboard, bmi2::kBishopData.tableSize> g_bishopAttacks;
 
@@ -77,6 +77,47 @@ namespace stormphrax::attacks {
 
             return dst;
         }
+
+        // Attacks of a slider along a single line of 8 squares,
+        // indexed by its position on the line and the line's occupancy
+        using LineAttacks = std::array<std::array<u8, 256>, 8>;
+
+        consteval LineAttacks generateLineAttacks() {
+            LineAttacks dst{};
+
+            for (i32 pos = 0; pos < 8; ++pos) {
+                for (u32 occ = 0; occ < 256; ++occ) {
+                    u32 attacks{};
+
+                    for (i32 i = pos + 1; i < 8; ++i) {
+                        attacks |= 1U << i;
+                        if (occ & (1U << i)) {
+                            break;
+                        }
+                    }
+
+                    for (i32 i = pos - 1; i >= 0; --i) {
+                        attacks |= 1U << i;
+                        if (occ & (1U << i)) {
+                            break;
+                        }
+                    }
+
+                    dst[pos][occ] = static_cast<u8>(attacks);
+                }
+            }
+
+            return dst;
+        }
+
+        [[nodiscard]] constexpr u32 rankOccupancy(u64 occ, i32 rank) {
+            return static_cast<u32>((occ >> (rank * 8)) & 0xFF);
+        }
+
+        // Gathers a file into a byte, with bit n holding rank n
+        [[nodiscard]] constexpr u32 fileOccupancy(u64 occ, i32 file) {
+            return static_cast<u32>((((occ >> file) & U64(0x0101010101010101)) * U64(0x0102040810204080)) >> 56);
+        }
     } // namespace internal
 
     template <i32... kDirs>
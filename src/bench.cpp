@@ -21,11 +21,6 @@
 #include <array>
 #include <string_view>
 
-#if SP_SPARSE_BENCH_L1_SIZE > 0
-    #include <fmt/ostream.h>
-    #include <fstream>
-#endif
-
 #include "opts.h"
 #include "position.h"
 #include "util/numa/numa.h"
@@ -92,6 +87,10 @@ namespace stormphrax::bench {
         "nqbnrkrb/pppppppp/8/8/8/8/PPPPPPPP/NQBNRKRB w GEge - 0 1"sv,
     };
 
+    std::span<const std::string_view> standardFens() {
+        return kStandardFens;
+    }
+
     void run(i32 depth, usize ttSize) {
         if (!eval::isNetworkLoaded()) {
             eprintln("No network loaded");
@@ -149,23 +148,19 @@ namespace stormphrax::bench {
         println("{:.3f} seconds", time);
         println("{} nodes {} nps", nodes, static_cast<usize>(static_cast<f64>(nodes) / time));
 
-        stats::print();
+        const auto refreshStats = thread.nnueState.refreshTableStats();
+        println(
+            "refresh table {} KiB, {:.2f}% hits",
+            refreshStats.bytes / 1024,
+            refreshStats.lookups == 0
+                ? 0.0
+                : static_cast<f64>(refreshStats.hits) * 100.0 / static_cast<f64>(refreshStats.lookups)
+        );
 
-#if SP_SPARSE_BENCH_L1_SIZE > 0
-        std::ofstream stream{"activations.txt", std::ios::binary};
-
-        bool first = true;
-        for (const auto count : eval::nnue::arch::sparse::g_activationCounts) {
-            if (!first) {
-                fmt::print(stream, ", ");
-            }
-            fmt::print(stream, "{}", count);
-            first = false;
-        }
-
-        fmt::println(stream, "");
+        stats::print();
 
-        println("Wrote FT activation counts to activations.txt");
+#ifdef SP_SEARCH_STATS
+        searcher.searchStats().print();
 #endif
     }
 } // namespace stormphrax::bench
@@ -20,16 +20,17 @@
 
 #include "types.h"
 
+#include <span>
+#include <string_view>
+
 #include "search.h"
 
 namespace stormphrax::bench {
-#if SP_SPARSE_BENCH_L1_SIZE > 0
-    constexpr i32 kDefaultBenchDepth = 17;
-#else
     constexpr i32 kDefaultBenchDepth = 13;
-#endif
 
     constexpr usize kDefaultBenchTtSize = 16;
 
     void run(i32 depth = kDefaultBenchDepth, usize ttSize = kDefaultBenchTtSize);
+
+    [[nodiscard]] std::span<const std::string_view> standardFens();
 } // namespace stormphrax::bench
@@ -24,9 +24,24 @@
 #include "tunable.h"
 
 namespace stormphrax {
+    CorrectionHistoryTable::CorrectionHistoryTable(std::span<Entry> entries, u32 sizeLog2) :
+            m_entries{entries.data()},
+            m_cont{entries.data() + (Colors::kCount * kTableCount << sizeLog2)},
+            m_sizeLog2{sizeLog2},
+            m_mask{(u64{1} << sizeLog2) - 1},
+            m_contMask{(kContTableSizeMultiplier << sizeLog2) - 1} {
+        assert(entries.size() == entryCount(sizeLog2));
+        assert(reinterpret_cast<uintptr_t>(entries.data()) % 64 == 0);
+    }
+
     void CorrectionHistoryTable::clear() {
-        std::memset(&m_tables, 0, sizeof(m_tables));
-        std::memset(&m_cont, 0, sizeof(m_cont));
+        std::memset(m_entries, 0, entryCount(m_sizeLog2) * sizeof(Entry));
+
+#ifdef SP_CORRHIST_STATS
+        if (m_writers) {
+            std::memset(m_writers, 0, entryCount(m_sizeLog2) / kEntriesPerLine * sizeof(std::atomic<u16>));
+        }
+#endif
     }
 
     void CorrectionHistoryTable::update(
@@ -36,20 +51,18 @@ namespace stormphrax {
         Score searchScore,
         Score staticEval
     ) {
-        auto& tables = m_tables[pos.stm().idx()];
-
         const auto bonus = std::clamp((searchScore - staticEval) * depth / 8, -kMaxBonus, kMaxBonus);
 
         const auto updateCont = [&](const u64 offset) {
             if (keyHistory.size() >= offset) {
-                m_cont[(pos.key() ^ keyHistory[keyHistory.size() - offset]) % kContEntries].update(bonus);
+                contEntry(pos.key(), keyHistory[keyHistory.size() - offset]).update(bonus);
             }
         };
 
-        tables.pawn[pos.pawnKey() % kEntries].update(bonus);
-        tables.blackNonPawn[pos.blackNonPawnKey() % kEntries].update(bonus);
-        tables.whiteNonPawn[pos.whiteNonPawnKey() % kEntries].update(bonus);
-        tables.major[pos.majorKey() % kEntries].update(bonus);
+        entry(pos.stm(), kPawn, pos.pawnKey()).update(bonus);
+        entry(pos.stm(), kBlackNonPawn, pos.blackNonPawnKey()).update(bonus);
+        entry(pos.stm(), kWhiteNonPawn, pos.whiteNonPawnKey()).update(bonus);
+        entry(pos.stm(), kMajor, pos.majorKey()).update(bonus);
 
         updateCont(1);
         updateCont(2);
@@ -59,11 +72,9 @@ namespace stormphrax {
     i32 CorrectionHistoryTable::correction(const Position& pos, std::span<const u64> keyHistory) const {
         using namespace tunable;
 
-        const auto& tables = m_tables[pos.stm().idx()];
-
         const auto contAdjustment = [&](const u64 offset, i32 weight) {
             if (keyHistory.size() >= offset) {
-                return weight * m_cont[(pos.key() ^ keyHistory[keyHistory.size() - offset]) % kContEntries];
+                return weight * contEntry(pos.key(), keyHistory[keyHistory.size() - offset]);
             } else {
                 return 0;
             }
@@ -71,10 +82,10 @@ namespace stormphrax {
 
         i32 correction{};
 
-        correction += pawnCorrhistWeight() * tables.pawn[pos.pawnKey() % kEntries];
-        correction += nonPawnCorrhistWeight() * tables.blackNonPawn[pos.blackNonPawnKey() % kEntries];
-        correction += nonPawnCorrhistWeight() * tables.whiteNonPawn[pos.whiteNonPawnKey() % kEntries];
-        correction += majorCorrhistWeight() * tables.major[pos.majorKey() % kEntries];
+        correction += pawnCorrhistWeight() * entry(pos.stm(), kPawn, pos.pawnKey());
+        correction += nonPawnCorrhistWeight() * entry(pos.stm(), kBlackNonPawn, pos.blackNonPawnKey());
+        correction += nonPawnCorrhistWeight() * entry(pos.stm(), kWhiteNonPawn, pos.whiteNonPawnKey());
+        correction += majorCorrhistWeight() * entry(pos.stm(), kMajor, pos.majorKey());
 
         correction += contAdjustment(1, contCorrhist1Weight());
         correction += contAdjustment(2, contCorrhist2Weight());
@@ -82,4 +93,38 @@ namespace stormphrax {
 
         return correction;
     }
+
+#ifdef SP_CORRHIST_STATS
+    void CorrectionHistoryTable::recordWrites(
+        const Position& pos,
+        std::span<const u64> keyHistory,
+        u16 writer,
+        WriteStats& stats
+    ) {
+        assert(m_writers);
+        assert(writer != 0);
+
+        const auto record = [&](const Entry& written) {
+            const auto line = static_cast<usize>(&written - m_entries) / kEntriesPerLine;
+            const auto prevWriter = m_writers[line].exchange(writer, std::memory_order::relaxed);
+
+            ++stats.writes;
+
+            if (prevWriter != 0 && prevWriter != writer) {
+                ++stats.foreignWrites;
+            }
+        };
+
+        record(entry(pos.stm(), kPawn, pos.pawnKey()));
+        record(entry(pos.stm(), kBlackNonPawn, pos.blackNonPawnKey()));
+        record(entry(pos.stm(), kWhiteNonPawn, pos.whiteNonPawnKey()));
+        record(entry(pos.stm(), kMajor, pos.majorKey()));
+
+        for (const u64 offset : {1, 2, 4}) {
+            if (keyHistory.size() >= offset) {
+                record(contEntry(pos.key(), keyHistory[keyHistory.size() - offset]));
+            }
+        }
+    }
+#endif
 } // namespace stormphrax
@@ -21,14 +21,57 @@
 #include "types.h"
 
 #include <atomic>
+#include <span>
 
 #include "core.h"
 #include "position.h"
-#include "util/multi_array.h"
+#include "util/range.h"
 
 namespace stormphrax {
+    // log2 of the number of entries in each of the keyed tables, per side to move
+    constexpr i32 kDefaultCorrhistSizeLog2 = 14;
+    constexpr util::Range<i32> kCorrhistSizeLog2Range{10, 22};
+
+    // Number of separate tables the threads on each NUMA node are split across
+    constexpr i32 kDefaultCorrhistShards = 1;
+    constexpr util::Range<i32> kCorrhistShardsRange{1, 2048};
+
+    // Does not own its entries, see Searcher
     class CorrectionHistoryTable {
     public:
+        struct Entry {
+            std::atomic<i16> value{};
+
+            inline void update(i32 bonus) {
+                auto v = value.load(std::memory_order::relaxed);
+                v += bonus - v * std::abs(bonus) / kLimit;
+                value.store(v, std::memory_order::relaxed);
+            }
+
+            [[nodiscard]] inline operator i32() const {
+                return value.load(std::memory_order::relaxed);
+            }
+        };
+
+        // Writes to a cache line last written by another thread, each of which implies a
+        // transfer of that line between cores. Only collected with SP_CORRHIST_STATS
+        struct WriteStats {
+            u64 writes{};
+            u64 foreignWrites{};
+        };
+
+        static constexpr usize kEntriesPerLine = 64 / sizeof(Entry);
+
+        // Number of entries backing a table of the given size
+        [[nodiscard]] static constexpr usize entryCount(u32 sizeLog2) {
+            return (Colors::kCount * kTableCount + kContTableSizeMultiplier) << sizeLog2;
+        }
+
+        CorrectionHistoryTable() = default;
+
+        // entries must be 64-byte aligned
+        CorrectionHistoryTable(std::span<Entry> entries, u32 sizeLog2);
+
         void clear();
 
         void update(
@@ -41,35 +84,69 @@ namespace stormphrax {
 
         [[nodiscard]] i32 correction(const Position& pos, std::span<const u64> keyHistory) const;
 
-    private:
-        static constexpr usize kEntries = 16384;
-        static constexpr usize kContEntries = 32768;
+#ifdef SP_PACKED_CORRHIST
+        // Called when a position is reached, ahead of its static eval
+        inline void prefetch(const Position& pos) const {
+            __builtin_prefetch(&entry(pos.stm(), kPawn, pos.pawnKey()));
+            __builtin_prefetch(&entry(pos.stm(), kBlackNonPawn, pos.blackNonPawnKey()));
+            __builtin_prefetch(&entry(pos.stm(), kWhiteNonPawn, pos.whiteNonPawnKey()));
+            __builtin_prefetch(&entry(pos.stm(), kMajor, pos.majorKey()));
+            __builtin_prefetch(&contEntry(pos.key(), 0));
+        }
+#endif
+
+#ifdef SP_CORRHIST_STATS
+        // writers must have one element per cache line of entries, writer must be nonzero
+        inline void setWriterTags(std::span<std::atomic<u16>> writers) {
+            assert(writers.size() == entryCount(m_sizeLog2) / kEntriesPerLine);
+            m_writers = writers.data();
+        }
 
+        // Call alongside update() with the same arguments
+        void recordWrites(const Position& pos, std::span<const u64> keyHistory, u16 writer, WriteStats& stats);
+#endif
+
+    private:
         static constexpr i32 kLimit = 1024;
         static constexpr i32 kMaxBonus = kLimit / 4;
 
-        struct Entry {
-            std::atomic<i16> value{};
+        static constexpr usize kPawn = 0;
+        static constexpr usize kBlackNonPawn = 1;
+        static constexpr usize kWhiteNonPawn = 2;
+        static constexpr usize kMajor = 3;
 
-            inline void update(i32 bonus) {
-                auto v = value.load(std::memory_order::relaxed);
-                v += bonus - v * std::abs(bonus) / kLimit;
-                value.store(v, std::memory_order::relaxed);
-            }
+        static constexpr usize kTableCount = 4;
 
-            [[nodiscard]] inline operator i32() const {
-                return value.load(std::memory_order::relaxed);
-            }
-        };
+        // The continuation table has this many times as many entries as each keyed table
+        static constexpr usize kContTableSizeMultiplier = 2;
 
-        struct SidedTables {
-            std::array<Entry, kEntries> pawn{};
-            std::array<Entry, kEntries> blackNonPawn{};
-            std::array<Entry, kEntries> whiteNonPawn{};
-            std::array<Entry, kEntries> major{};
-        };
+        Entry* m_entries{};
+        Entry* m_cont{};
+
+        u32 m_sizeLog2{};
+        u64 m_mask{};
+        u64 m_contMask{};
+
+#ifdef SP_CORRHIST_STATS
+        std::atomic<u16>* m_writers{};
+#endif
+
+        [[nodiscard]] inline Entry& entry(Color stm, usize table, u64 key) const {
+            return m_entries[((stm.idx() * kTableCount + table) << m_sizeLog2) + (key & m_mask)];
+        }
 
-        std::array<SidedTables, Colors::kCount> m_tables{};
-        std::array<Entry, kContEntries> m_cont{};
+#ifdef SP_PACKED_CORRHIST
+        // The line is picked by the current position's key, and the entry within it by the previous
+        // position's, so all continuation lookups for a position share one cache line
+        [[nodiscard]] inline Entry& contEntry(u64 key, u64 prevKey) const {
+            const auto line = key & (m_contMask / kEntriesPerLine);
+            const auto idx = ((key ^ prevKey) >> 32) % kEntriesPerLine;
+            return m_cont[line * kEntriesPerLine + idx];
+        }
+#else
+        [[nodiscard]] inline Entry& contEntry(u64 key, u64 prevKey) const {
+            return m_cont[(key ^ prevKey) & m_contMask];
+        }
+#endif
     };
 } // namespace stormphrax
@@ -20,18 +20,56 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <exception>
+#include <new>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+#endif
 
 #include "attacks/attacks.h"
 #include "keys.h"
+#include "util/align.h"
 
 namespace stormphrax::cuckoo {
     // https://web.archive.org/web/20201107002606/https://marcelk.net/2013-04-06/paper/upcoming-rep-v2.pdf
     // Implementation based on Stockfish's
 
-    std::array<u64, 8192> keys{};
-    std::array<Move, 8192> moves{};
+    namespace {
+#ifdef MADV_HUGEPAGE
+        constexpr usize kHugePageSize = 2 * 1024 * 1024;
+        static_assert(sizeof(Tables) <= kHugePageSize);
+
+        // padded to a whole huge page, as only fully covered huge pages can be used
+        constexpr usize kTablesAlignment = kHugePageSize;
+        constexpr usize kTablesAllocSize = kHugePageSize;
+#else
+        constexpr usize kTablesAlignment = 64;
+        constexpr usize kTablesAllocSize = sizeof(Tables);
+        static_assert(kTablesAllocSize % kTablesAlignment == 0);
+#endif
+    } // namespace
+
+    const Tables* g_tables{};
 
     void init() {
+        auto* memory = util::alignedAlloc<std::byte>(kTablesAlignment, kTablesAllocSize);
+
+        if (!memory) {
+            eprintln("Failed to allocate cuckoo tables - out of memory?");
+            std::terminate();
+        }
+
+#ifdef MADV_HUGEPAGE
+        madvise(memory, kTablesAllocSize, MADV_HUGEPAGE);
+#endif
+
+        auto* tables = new (memory) Tables{};
+
+        auto& keys = tables->keys;
+        auto& moves = tables->moves;
+
         [[maybe_unused]] u32 count = 0;
 
         // skip pawns
@@ -70,5 +108,7 @@ namespace stormphrax::cuckoo {
         }
 
         assert(count == 3668);
+
+        g_tables = tables;
     }
 } // namespace stormphrax::cuckoo
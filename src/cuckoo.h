@@ -33,8 +33,22 @@ namespace stormphrax::cuckoo {
         return static_cast<usize>((key >> 16) & 0x1FFF);
     }
 
-    extern std::array<u64, 8192> keys;
-    extern std::array<Move, 8192> moves;
+    struct Tables {
+        std::array<u64, 8192> keys;
+        std::array<Move, 8192> moves;
+    };
+
+    // Allocated by init() on its own huge page where possible, as lookups
+    // are scattered over the whole table and would otherwise touch many pages
+    extern const Tables* g_tables;
+
+    [[nodiscard]] inline u64 key(usize slot) {
+        return g_tables->keys[slot];
+    }
+
+    [[nodiscard]] inline Move move(usize slot) {
+        return g_tables->moves[slot];
+    }
 
     void init();
 } // namespace stormphrax::cuckoo
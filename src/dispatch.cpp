@@ -0,0 +1,108 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Entry point for multi-arch builds (make multi). Every other translation unit is compiled
+// once per variant in build.mk, and each variant is partially linked into a single object
+// exporting only its SP_DISPATCH_ENTRY. This file is compiled for baseline x86-64, so it
+// must not touch anything variant-specific before a variant has been selected
+#ifdef SP_DISPATCH
+
+    #include "types.h"
+
+    #include <array>
+    #include <cstdlib>
+    #include <string_view>
+
+using namespace stormphrax;
+
+// keep in sync with MULTI_VARIANTS in build.mk
+extern "C" {
+i32 sp_entry_avx512(i32 argc, const char* argv[]);
+i32 sp_entry_avx2_bmi2(i32 argc, const char* argv[]);
+i32 sp_entry_zen2(i32 argc, const char* argv[]);
+}
+
+namespace {
+    struct Variant {
+        std::string_view name;
+        bool (*supported)();
+        i32 (*entry)(i32, const char*[]);
+    };
+
+    // __builtin_cpu_supports requires string literals, so these can't be table-driven
+
+    bool hasAvx2() {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("bmi")
+            && __builtin_cpu_supports("bmi2");
+    }
+
+    // Zen 1 and 2 (and older AMD cpus) implement pext and pdep in microcode
+    bool hasFastPext() {
+        return hasAvx2() && !__builtin_cpu_is("amdfam15h") && !__builtin_cpu_is("amdfam17h");
+    }
+
+    // Variants in order of preference. These checks cover at least
+    // what util::cpu::missingBuildFeatures checks for each build type
+    constexpr std::array kVariants = {
+        Variant{
+            "avx512",
+            [] {
+                return hasFastPext() && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+                    && __builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512vbmi")
+                    && __builtin_cpu_supports("avx512vbmi2");
+            },
+            sp_entry_avx512,
+        },
+        Variant{"avx2-bmi2", hasFastPext, sp_entry_avx2_bmi2},
+        Variant{"zen2", hasAvx2, sp_entry_zen2},
+    };
+} // namespace
+
+i32 main(i32 argc, const char* argv[]) {
+    __builtin_cpu_init();
+
+    // allows forcing a specific variant, for testing and benchmarking
+    if (const auto* forced = std::getenv("SP_VARIANT")) {
+        for (const auto& variant : kVariants) {
+            if (variant.name != forced) {
+                continue;
+            }
+
+            if (!variant.supported()) {
+                eprintln("Variant {} is not supported by this machine", variant.name);
+                return 1;
+            }
+
+            return variant.entry(argc, argv);
+        }
+
+        eprintln("Unknown variant '{}'", forced);
+        return 1;
+    }
+
+    for (const auto& variant : kVariants) {
+        if (variant.supported()) {
+            return variant.entry(argc, argv);
+        }
+    }
+
+    eprintln("This build of Stormphrax requires at least AVX2, FMA, BMI and BMI2");
+    return 1;
+}
+
+#endif // SP_DISPATCH
@@ -0,0 +1,41 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <array>
+
+namespace stormphrax::eval {
+    // Activation dumps are written by "evalbench activations" and read by the permute
+    // tool to reorder FT neurons. The header is followed by one bitset of neurons / 8
+    // bytes per sample, with bit n (byte n / 8, bit n % 8) set if pairwise FT output n
+    // was nonzero. Each evaluation contributes one sample per perspective
+    constexpr std::array kActivationDumpMagic{'S', 'P', 'A', 'D'};
+    constexpr u16 kActivationDumpVersion = 1;
+
+    struct __attribute__((packed)) ActivationDumpHeader {
+        std::array<char, 4> magic{kActivationDumpMagic};
+        u16 version{kActivationDumpVersion};
+        u16 neurons{};
+        u64 samples{};
+    };
+
+    static_assert(sizeof(ActivationDumpHeader) == 16);
+} // namespace stormphrax::eval
@@ -0,0 +1,908 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "evalbench.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <memory>
+
+#include <fmt/ostream.h>
+
+#include "../bench.h"
+#include "../movegen.h"
+#include "../opts.h"
+#include "../position.h"
+#include "../util/numa/numa.h"
+#include "../util/rng.h"
+#include "../util/split.h"
+#include "../util/timer.h"
+#include "activations.h"
+#include "nnue/features/threats/geometry.h"
+#include "nnue_state.h"
+
+namespace stormphrax::eval::bench {
+    using util::Instant;
+
+    namespace {
+        constexpr u64 kTrajectorySeed = 0x5EED5EED;
+
+        constexpr i32 kMaxQsearchPly = 4;
+
+        constexpr usize kMaxLayerSamples = 4096;
+        constexpr usize kLayerRepetitions = 8;
+
+        // 32 MiB of bitsets for a 1024-wide FT
+        constexpr usize kMaxActivationSamples = 1 << 19;
+
+        constexpr usize kMaxThreatSamples = 1 << 16;
+        constexpr usize kThreatRepetitions = 16;
+
+        constexpr u32 kL2SizeFull = kL2Size * (1 + kDualActivation);
+
+        struct StageTime {
+            f64 total{};
+            usize calls{};
+
+            inline void add(f64 time, usize count = 1) {
+                total += time;
+                calls += count;
+            }
+        };
+
+        struct LayerSample {
+            // stm psq, nstm psq, stm threats, nstm threats
+            std::array<util::simd::Array<i16, kL1Size>, 4> inputs;
+            u32 bucket;
+        };
+
+        void fillSample(const NnueState& nnueState, const Position& pos, LayerSample& sample) {
+            const auto& acc = nnueState.current();
+
+            const auto stm = pos.stm();
+            const auto nstm = pos.nstm();
+
+            std::ranges::copy(acc.psqAcc.forColor(stm), sample.inputs[0].begin());
+            std::ranges::copy(acc.psqAcc.forColor(nstm), sample.inputs[1].begin());
+
+            if constexpr (InputFeatureSet::kThreatInputs) {
+                std::ranges::copy(acc.threatAcc[0].forColor(stm), sample.inputs[2].begin());
+                std::ranges::copy(acc.threatAcc[0].forColor(nstm), sample.inputs[3].begin());
+            }
+
+            sample.bucket = OutputBucketing::getBucket(pos);
+        }
+
+        [[nodiscard]] usize countOps(std::span<const Trajectory> trajectories, OpType type) {
+            usize count{};
+
+            for (const auto& trajectory : trajectories) {
+                count += std::ranges::count(trajectory.ops, type, &TrajectoryOp::type);
+            }
+
+            return count;
+        }
+
+        void walk(
+            const Position& pos,
+            i32 depth,
+            i32 qsPly,
+            util::rng::Jsf64Rng& rng,
+            std::vector<TrajectoryOp>& ops
+        ) {
+            // search evaluates almost every node, but some are cut early enough not to
+            if (rng.nextU32(8) != 0) {
+                ops.push_back({OpType::kEval});
+            }
+
+            ScoredMoveList moves{};
+            u32 maxChildren;
+
+            if (depth > 0) {
+                generateAll(moves, pos);
+                maxChildren = depth >= 4 ? 4 : 2;
+            } else {
+                if (qsPly >= kMaxQsearchPly) {
+                    return;
+                }
+
+                generateNoisy(moves, pos);
+                maxChildren = 2;
+            }
+
+            const auto children = std::min<u32>(maxChildren, moves.size());
+
+            for (u32 i = 0; i < children; ++i) {
+                const auto idx = i + rng.nextU32(moves.size() - i);
+                std::swap(moves[i], moves[idx]);
+
+                const auto move = moves[i].move;
+
+                ops.push_back({OpType::kPush, move});
+                walk(pos.applyMove(move), std::max(depth - 1, 0), depth > 0 ? 0 : qsPly + 1, rng, ops);
+                ops.push_back({OpType::kPop});
+            }
+        }
+
+        [[nodiscard]] f64 timerOverhead() {
+            static constexpr usize kIterations = 1 << 16;
+
+            f64 total{};
+
+            for (usize i = 0; i < kIterations; ++i) {
+                const auto start = Instant::now();
+                total += start.elapsed();
+            }
+
+            return total / static_cast<f64>(kIterations);
+        }
+
+        enum class ThreatCallType : u8 {
+            kAdd,
+            kRemove,
+            kMutate,
+            kMove,
+        };
+
+        // One call into the threat delta generation, as made by BoardObserver
+        struct ThreatCall {
+            ThreatCallType type;
+            Piece piece;
+            Piece newPiece{Pieces::kNone}; // only valid for kMutate and kMove
+            Square sq;
+            Square dst{Squares::kNone}; // only valid for kMove
+        };
+
+        // Mirrors the observer calls made by Position::applyMove. All calls are replayed
+        // against the board after the move, which is exact for the final call of each
+        // move and close enough for the others, since only a square or two differ
+        void appendThreatCalls(const Position& pos, Move move, std::vector<ThreatCall>& calls) {
+            const auto src = move.fromSq();
+            const auto dst = move.toSq();
+
+            const auto piece = pos.pieceOn(src);
+
+            switch (move.type()) {
+                case MoveType::kCastling: {
+                    const auto rook = pos.pieceOn(dst);
+
+                    const bool isShort = src.file() < dst.file();
+
+                    const auto kingDst = src.withFile(isShort ? kFileG : kFileC);
+                    const auto rookDst = src.withFile(isShort ? kFileF : kFileD);
+
+                    calls.push_back({.type = ThreatCallType::kRemove, .piece = piece, .sq = src});
+                    calls.push_back({.type = ThreatCallType::kRemove, .piece = rook, .sq = dst});
+                    calls.push_back({.type = ThreatCallType::kAdd, .piece = piece, .sq = kingDst});
+                    calls.push_back({.type = ThreatCallType::kAdd, .piece = rook, .sq = rookDst});
+
+                    break;
+                }
+
+                case MoveType::kEnPassant:
+                    calls.push_back({
+                        .type = ThreatCallType::kRemove,
+                        .piece = piece.flipColor(),
+                        .sq = dst.flipRankParity(),
+                    });
+                    calls.push_back({
+                        .type = ThreatCallType::kMove,
+                        .piece = piece,
+                        .newPiece = piece,
+                        .sq = src,
+                        .dst = dst,
+                    });
+                    break;
+
+                default: {
+                    const auto newPiece = move.type() == MoveType::kPromotion ? piece.copyColor(move.promo()) : piece;
+                    const auto captured = pos.pieceOn(dst);
+
+                    if (captured != Pieces::kNone) {
+                        calls.push_back({.type = ThreatCallType::kRemove, .piece = piece, .sq = src});
+                        calls.push_back({
+                            .type = ThreatCallType::kMutate,
+                            .piece = captured,
+                            .newPiece = newPiece,
+                            .sq = dst,
+                        });
+                    } else {
+                        calls.push_back({
+                            .type = ThreatCallType::kMove,
+                            .piece = piece,
+                            .newPiece = newPiece,
+                            .sq = src,
+                            .dst = dst,
+                        });
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        [[nodiscard]] constexpr u64 mixThreat(u32 threat) {
+            const auto v = static_cast<u64>(threat) * 0x9E3779B97F4A7C15;
+            return v ^ (v >> 29);
+        }
+
+        void applyThreatCall(NnueUpdates& updates, const Position& pos, const ThreatCall& call) {
+            switch (call.type) {
+                case ThreatCallType::kAdd:
+                    updatePieceThreatsOnChange<true>(updates, pos, call.piece, call.sq);
+                    break;
+                case ThreatCallType::kRemove:
+                    updatePieceThreatsOnChange<false>(updates, pos, call.piece, call.sq);
+                    break;
+                case ThreatCallType::kMutate:
+                    updatePieceThreatsOnMutate(updates, pos, call.piece, call.newPiece, call.sq);
+                    break;
+                case ThreatCallType::kMove:
+                    updatePieceThreatsOnMove(updates, pos, call.piece, call.sq, call.newPiece, call.dst);
+                    break;
+            }
+        }
+    } // namespace
+
+    std::vector<Trajectory> generateTrajectories(i32 depth) {
+        std::vector<Trajectory> trajectories{};
+
+        util::rng::Jsf64Rng rng{kTrajectorySeed};
+
+        for (const auto fen : stormphrax::bench::standardFens()) {
+            auto& trajectory = trajectories.emplace_back();
+            trajectory.fen = std::string{fen};
+
+            walk(*Position::fromFen(fen), depth, 0, rng, trajectory.ops);
+        }
+
+        return trajectories;
+    }
+
+    std::vector<Trajectory> generateTrajectories(std::span<const std::string> fens, i32 depth) {
+        std::vector<Trajectory> trajectories{};
+        trajectories.reserve(fens.size());
+
+        util::rng::Jsf64Rng rng{kTrajectorySeed};
+
+        for (const auto& fen : fens) {
+            const auto pos = Position::fromFen(fen);
+
+            if (!pos) {
+                continue;
+            }
+
+            auto& trajectory = trajectories.emplace_back();
+            trajectory.fen = fen;
+
+            walk(*pos, depth, 0, rng, trajectory.ops);
+        }
+
+        return trajectories;
+    }
+
+    std::optional<std::vector<std::string>> loadDataset(const std::string& path) {
+        std::ifstream stream{path, std::ios::binary};
+
+        if (!stream) {
+            eprintln("failed to open {}", path);
+            return {};
+        }
+
+        std::vector<std::string> fens{};
+
+        for (std::string line{}; std::getline(stream, line);) {
+            auto fen = std::string_view{line}.substr(0, line.find_first_of("|[;"));
+
+            while (!fen.empty() && std::isspace(static_cast<unsigned char>(fen.back()))) {
+                fen.remove_suffix(1);
+            }
+
+            if (!fen.empty()) {
+                fens.emplace_back(fen);
+            }
+        }
+
+        return fens;
+    }
+
+    bool saveTrajectories(const std::string& path, std::span<const Trajectory> trajectories) {
+        std::ofstream stream{path, std::ios::binary};
+
+        if (!stream) {
+            eprintln("failed to open {}", path);
+            return false;
+        }
+
+        for (const auto& trajectory : trajectories) {
+            fmt::print(stream, "{};", trajectory.fen);
+
+            bool first = true;
+            for (const auto [type, move] : trajectory.ops) {
+                if (!first) {
+                    fmt::print(stream, " ");
+                }
+
+                switch (type) {
+                    case OpType::kPush:
+                        fmt::print(stream, "{}", move);
+                        break;
+                    case OpType::kPop:
+                        fmt::print(stream, "-");
+                        break;
+                    case OpType::kEval:
+                        fmt::print(stream, "e");
+                        break;
+                }
+
+                first = false;
+            }
+
+            fmt::println(stream, "");
+        }
+
+        return true;
+    }
+
+    std::optional<std::vector<Trajectory>> loadTrajectories(const std::string& path) {
+        std::ifstream stream{path, std::ios::binary};
+
+        if (!stream) {
+            eprintln("failed to open {}", path);
+            return {};
+        }
+
+        std::vector<Trajectory> trajectories{};
+        std::vector<std::string_view> tokens{};
+
+        for (std::string line{}; std::getline(stream, line);) {
+            if (line.empty()) {
+                continue;
+            }
+
+            const auto separator = line.find(';');
+
+            if (separator == std::string::npos) {
+                eprintln("invalid trajectory '{}'", line);
+                return {};
+            }
+
+            auto& trajectory = trajectories.emplace_back();
+            trajectory.fen = line.substr(0, separator);
+
+            const auto root = Position::fromFen(trajectory.fen);
+
+            if (!root) {
+                return {};
+            }
+
+            std::vector<Position> positions{*root};
+
+            tokens.clear();
+            split::split(tokens, std::string_view{line}.substr(separator + 1), ' ');
+
+            for (const auto token : tokens) {
+                if (token.empty()) {
+                    continue;
+                } else if (token == "e") {
+                    trajectory.ops.push_back({OpType::kEval});
+                } else if (token == "-") {
+                    if (positions.size() <= 1) {
+                        eprintln("pop past root in trajectory for {}", trajectory.fen);
+                        return {};
+                    }
+
+                    positions.pop_back();
+                    trajectory.ops.push_back({OpType::kPop});
+                } else {
+                    const auto move = positions.back().moveFromUci(token);
+
+                    if (!move || !positions.back().isLegal(move)) {
+                        eprintln("invalid move {} in trajectory for {}", token, trajectory.fen);
+                        return {};
+                    }
+
+                    positions.push_back(positions.back().applyMove(move));
+                    trajectory.ops.push_back({OpType::kPush, move});
+                }
+            }
+        }
+
+        return trajectories;
+    }
+
+    void run(std::span<const Trajectory> trajectories) {
+        if (!isNetworkLoaded()) {
+            eprintln("No network loaded");
+            return;
+        }
+
+        numa::bindThread(0);
+
+        const auto& network = *getNetwork(0);
+        const auto& arch = network.arch();
+
+        auto nnueState = std::make_unique<NnueState>();
+        nnueState->setNetwork(&network);
+        nnueState->setRefreshTableSize(static_cast<u32>(g_opts.refreshTableSize));
+
+        const auto overhead = timerOverhead();
+
+        StageTime pushTime{};
+        StageTime ensureTime{};
+        StageTime evaluateTime{};
+        StageTime refreshPsqTime{};
+        StageTime refreshThreatTime{};
+        StageTime activateFtTime{};
+        StageTime l1Time{};
+        StageTime l2Time{};
+        StageTime l3Time{};
+
+        const auto totalEvals = countOps(trajectories, OpType::kEval);
+
+        const auto sampleStride = std::max<usize>(1, totalEvals / kMaxLayerSamples);
+
+        std::vector<LayerSample> samples{};
+        std::vector<Position> samplePositions{};
+
+        samples.reserve(kMaxLayerSamples + 1);
+        samplePositions.reserve(kMaxLayerSamples + 1);
+
+        i64 evalChecksum{};
+        usize evalIdx{};
+
+        std::vector<Position> positions{};
+        positions.reserve(256);
+
+        for (const auto& trajectory : trajectories) {
+            const auto root = Position::fromFen(trajectory.fen);
+
+            if (!root) {
+                continue;
+            }
+
+            nnueState->reset(*root);
+
+            positions.clear();
+            positions.push_back(*root);
+
+            for (const auto [type, move] : trajectory.ops) {
+                switch (type) {
+                    case OpType::kPush: {
+                        const auto start = Instant::now();
+                        const auto child = positions.back().applyMove(move, nnueState->push());
+                        pushTime.add(start.elapsed());
+
+                        positions.push_back(child);
+                        break;
+                    }
+
+                    case OpType::kPop:
+                        nnueState->pop();
+                        positions.pop_back();
+                        break;
+
+                    case OpType::kEval: {
+                        const auto& pos = positions.back();
+
+                        const auto start = Instant::now();
+                        nnueState->ensureUpToDate(pos);
+                        const auto updated = start.elapsed();
+                        const auto score = nnueState->evaluate(pos, pos.stm());
+                        const auto evaluated = start.elapsed();
+
+                        ensureTime.add(updated);
+                        evaluateTime.add(evaluated - updated);
+
+                        evalChecksum += score;
+
+                        if (evalIdx++ % sampleStride == 0 && samples.size() < kMaxLayerSamples) {
+                            fillSample(*nnueState, pos, samples.emplace_back());
+                            samplePositions.push_back(pos);
+                        }
+
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!samplePositions.empty()) {
+            nnueState->reset(samplePositions[0]);
+
+            for (const auto& pos : samplePositions) {
+                for (const auto c : {Colors::kBlack, Colors::kWhite}) {
+                    auto start = Instant::now();
+                    nnueState->refreshPsq(pos, c);
+                    refreshPsqTime.add(start.elapsed());
+
+                    if constexpr (InputFeatureSet::kThreatInputs) {
+                        start = Instant::now();
+                        nnueState->refreshThreats(pos, c);
+                        refreshThreatTime.add(start.elapsed());
+                    }
+                }
+            }
+        }
+
+        using SparseContext = nnue::arch::sparse::SparseContext<kL1Size>;
+
+        std::vector<util::simd::Array<u8, kL1Size>> ftOut(samples.size());
+        std::vector<SparseContext> sparseCtxs(samples.size());
+        std::vector<util::simd::Array<i32, kL2SizeFull>> l1Out(samples.size());
+        std::vector<util::simd::Array<i32, kL3Size>> l2Out(samples.size());
+
+        util::simd::Array<i32, 1> l3Out{};
+
+        i64 layerChecksum{};
+
+        for (usize rep = 0; rep < kLayerRepetitions; ++rep) {
+            std::ranges::fill(sparseCtxs, SparseContext{});
+
+            auto start = Instant::now();
+            for (usize i = 0; i < samples.size(); ++i) {
+                const auto& inputs = samples[i].inputs;
+                arch.activateFt(inputs[0], inputs[1], inputs[2], inputs[3], ftOut[i], sparseCtxs[i]);
+            }
+            activateFtTime.add(start.elapsed(), samples.size());
+
+            start = Instant::now();
+            for (usize i = 0; i < samples.size(); ++i) {
+                arch.propagateL1(samples[i].bucket, ftOut[i], l1Out[i], sparseCtxs[i]);
+            }
+            l1Time.add(start.elapsed(), samples.size());
+
+            start = Instant::now();
+            for (usize i = 0; i < samples.size(); ++i) {
+                arch.propagateL2(samples[i].bucket, l1Out[i], l2Out[i]);
+            }
+            l2Time.add(start.elapsed(), samples.size());
+
+            start = Instant::now();
+            for (usize i = 0; i < samples.size(); ++i) {
+                arch.propagateL3(samples[i].bucket, l1Out[i], l2Out[i], l3Out);
+                layerChecksum += l3Out[0];
+            }
+            l3Time.add(start.elapsed(), samples.size());
+        }
+
+        usize nonzeroOutputs{};
+        usize nonzeroChunks{};
+
+        for (usize i = 0; i < samples.size(); ++i) {
+            nonzeroOutputs += std::ranges::count_if(ftOut[i], [](u8 v) { return v != 0; });
+            nonzeroChunks += sparseCtxs[i].count();
+        }
+
+        const auto printStage = [&](std::string_view name, const StageTime& stage, bool perCall) {
+            if (stage.calls == 0) {
+                return;
+            }
+
+            // batched stages only pay the timer overhead once per batch
+            const auto timers = perCall ? static_cast<f64>(stage.calls) : static_cast<f64>(kLayerRepetitions);
+            const auto corrected = std::max(stage.total - overhead * timers, 0.0);
+
+            println(
+                "{:<28} {:>10} {:>10.1f}",
+                name,
+                stage.calls,
+                corrected * 1000000000.0 / static_cast<f64>(stage.calls)
+            );
+        };
+
+        const auto pushes = countOps(trajectories, OpType::kPush);
+
+        println(
+            "{} trajectories, {} pushes, {} evals, {} layer samples",
+            trajectories.size(),
+            pushes,
+            totalEvals,
+            samples.size()
+        );
+        println("timer overhead {:.1f} ns (subtracted)", overhead * 1000000000.0);
+
+        const auto refreshStats = nnueState->refreshTableStats();
+        println(
+            "refresh table {} KiB, {:.2f}% hits",
+            refreshStats.bytes / 1024,
+            refreshStats.lookups == 0
+                ? 0.0
+                : static_cast<f64>(refreshStats.hits) * 100.0 / static_cast<f64>(refreshStats.lookups)
+        );
+
+        println();
+
+        println("{:<28} {:>10} {:>10}", "stage", "calls", "ns/op");
+        printStage("push (applyMove + deltas)", pushTime, true);
+        printStage("ensureUpToDate", ensureTime, true);
+        printStage("evaluate", evaluateTime, true);
+        printStage("refreshPsqAccumulator", refreshPsqTime, true);
+        printStage("refreshThreatAccumulator", refreshThreatTime, true);
+        printStage("activateFt", activateFtTime, false);
+        printStage("propagateL1", l1Time, false);
+        printStage("propagateL2", l2Time, false);
+        printStage("propagateL3", l3Time, false);
+
+        if (!samples.empty()) {
+            const auto sampleCount = static_cast<f64>(samples.size());
+
+            println();
+            println(
+                "FT outputs nonzero: {:.2f}%",
+                static_cast<f64>(nonzeroOutputs) * 100.0 / (sampleCount * kL1Size)
+            );
+            println(
+                "L1 input chunks nonzero: {:.2f}% (avg {:.1f} of {})",
+                static_cast<f64>(nonzeroChunks) * 100.0 / (sampleCount * (kL1Size / 4)),
+                static_cast<f64>(nonzeroChunks) / sampleCount,
+                kL1Size / 4
+            );
+        }
+
+        println();
+        println("eval checksum {}", evalChecksum);
+        println("layer checksum {}", layerChecksum / static_cast<i64>(kLayerRepetitions));
+    }
+
+    bool dumpActivations(std::span<const Trajectory> trajectories, const std::string& path) {
+        static constexpr u32 kPairCount = kL1Size / 2;
+        static constexpr usize kSampleBytes = kPairCount / 8;
+
+        static_assert(kPairCount % 8 == 0);
+
+        if (!isNetworkLoaded()) {
+            eprintln("No network loaded");
+            return false;
+        }
+
+        std::ofstream stream{path, std::ios::binary};
+
+        if (!stream) {
+            eprintln("failed to open {}", path);
+            return false;
+        }
+
+        numa::bindThread(0);
+
+        const auto& network = *getNetwork(0);
+        const auto& arch = network.arch();
+
+        auto nnueState = std::make_unique<NnueState>();
+        nnueState->setNetwork(&network);
+
+        // each evaluation produces a sample per perspective
+        const auto evalStride = std::max<usize>(1, countOps(trajectories, OpType::kEval) / (kMaxActivationSamples / 2));
+
+        std::vector<std::array<u8, kSampleBytes>> samples{};
+
+        usize nonzeroChunks{};
+        usize evalIdx{};
+
+        auto sample = std::make_unique<LayerSample>();
+
+        util::simd::Array<u8, kL1Size> ftOut{};
+        nnue::arch::sparse::SparseContext<kL1Size> sparseCtx{};
+
+        std::vector<Position> positions{};
+        positions.reserve(256);
+
+        for (const auto& trajectory : trajectories) {
+            const auto root = Position::fromFen(trajectory.fen);
+
+            if (!root) {
+                continue;
+            }
+
+            nnueState->reset(*root);
+
+            positions.clear();
+            positions.push_back(*root);
+
+            for (const auto [type, move] : trajectory.ops) {
+                switch (type) {
+                    case OpType::kPush:
+                        positions.push_back(positions.back().applyMove(move, nnueState->push()));
+                        break;
+
+                    case OpType::kPop:
+                        nnueState->pop();
+                        positions.pop_back();
+                        break;
+
+                    case OpType::kEval: {
+                        if (evalIdx++ % evalStride != 0 || samples.size() >= kMaxActivationSamples) {
+                            break;
+                        }
+
+                        const auto& pos = positions.back();
+
+                        nnueState->ensureUpToDate(pos);
+                        fillSample(*nnueState, pos, *sample);
+
+                        const auto& inputs = sample->inputs;
+
+                        sparseCtx = {};
+                        arch.activateFt(inputs[0], inputs[1], inputs[2], inputs[3], ftOut, sparseCtx);
+
+                        nonzeroChunks += sparseCtx.count();
+
+                        for (u32 half = 0; half < 2; ++half) {
+                            auto& bits = samples.emplace_back();
+                            bits.fill(0);
+
+                            for (u32 neuron = 0; neuron < kPairCount; ++neuron) {
+                                if (ftOut[half * kPairCount + neuron] != 0) {
+                                    bits[neuron / 8] |= static_cast<u8>(1 << (neuron % 8));
+                                }
+                            }
+                        }
+
+                        break;
+                    }
+                }
+            }
+        }
+
+        const ActivationDumpHeader header{
+            .neurons = static_cast<u16>(kPairCount),
+            .samples = samples.size(),
+        };
+
+        if (!stream.write(reinterpret_cast<const char*>(&header), sizeof(header))
+            || !stream.write(reinterpret_cast<const char*>(samples.data()), samples.size() * kSampleBytes))
+        {
+            eprintln("failed to write activations to {}", path);
+            return false;
+        }
+
+        println("Wrote {} activation samples to {}", samples.size(), path);
+
+        if (!samples.empty()) {
+            // the sparse context covers both perspectives, which are separate samples
+            const auto evals = static_cast<f64>(samples.size() / 2);
+            println(
+                "L1 input chunks nonzero: {:.2f}% (avg {:.1f} of {})",
+                static_cast<f64>(nonzeroChunks) * 100.0 / (evals * (kL1Size / 4)),
+                static_cast<f64>(nonzeroChunks) / evals,
+                kL1Size / 4
+            );
+        }
+
+        return true;
+    }
+
+    void runThreats(std::span<const Trajectory> trajectories) {
+        if constexpr (!InputFeatureSet::kThreatInputs) {
+            eprintln("Network has no threat inputs");
+            return;
+        } else {
+            namespace geometry = nnue::features::threats::geometry;
+
+            const auto stride = std::max<usize>(1, countOps(trajectories, OpType::kPush) / kMaxThreatSamples);
+
+            // boards after each sampled move, and the calls each move made
+            std::vector<Position> boards{};
+            std::vector<usize> callOffsets{};
+            std::vector<ThreatCall> calls{};
+
+            boards.reserve(kMaxThreatSamples + 1);
+            callOffsets.reserve(kMaxThreatSamples + 2);
+            calls.reserve(kMaxThreatSamples * 2);
+
+            usize pushIdx{};
+
+            std::vector<Position> positions{};
+            positions.reserve(256);
+
+            for (const auto& trajectory : trajectories) {
+                const auto root = Position::fromFen(trajectory.fen);
+
+                if (!root) {
+                    continue;
+                }
+
+                positions.clear();
+                positions.push_back(*root);
+
+                for (const auto [type, move] : trajectory.ops) {
+                    if (type == OpType::kPop) {
+                        positions.pop_back();
+                    } else if (type == OpType::kPush) {
+                        const auto& pos = positions.back();
+                        const auto child = pos.applyMove(move);
+
+                        if (pushIdx++ % stride == 0 && boards.size() < kMaxThreatSamples) {
+                            callOffsets.push_back(calls.size());
+                            appendThreatCalls(pos, move, calls);
+                            boards.push_back(child);
+                        }
+
+                        positions.push_back(child);
+                    }
+                }
+            }
+
+            callOffsets.push_back(calls.size());
+
+            if (boards.empty()) {
+                eprintln("No moves to replay");
+                return;
+            }
+
+            auto updates = std::make_unique<NnueUpdates>();
+
+            usize threats{};
+            u64 checksum{};
+
+            const auto replay = [&] {
+                for (usize idx = 0; idx < boards.size(); ++idx) {
+                    updates->threatsAdded.clear();
+                    updates->threatsRemoved.clear();
+
+                    for (auto call = callOffsets[idx]; call < callOffsets[idx + 1]; ++call) {
+                        applyThreatCall(*updates, boards[idx], calls[call]);
+                    }
+
+                    threats += updates->threatsAdded.size() + updates->threatsRemoved.size();
+
+                    // order independent, so backends that emit threats in a different order still match
+                    for (const auto& threat : updates->threatsAdded) {
+                        checksum += mixThreat(std::bit_cast<u32>(threat));
+                    }
+
+                    for (const auto& threat : updates->threatsRemoved) {
+                        checksum -= mixThreat(std::bit_cast<u32>(threat));
+                    }
+                }
+            };
+
+            // warm up caches and count threats once
+            replay();
+
+            const auto threatsPerPass = threats;
+            const auto checksumPerPass = checksum;
+
+            const auto start = Instant::now();
+
+            for (usize rep = 0; rep < kThreatRepetitions; ++rep) {
+                replay();
+            }
+
+            const auto time = start.elapsed();
+            const auto passes = static_cast<f64>(kThreatRepetitions);
+
+            println("threat backend {}", geometry::kBackendName);
+            println("{} moves, {} calls, {} threats", boards.size(), calls.size(), threatsPerPass);
+            println();
+
+            println("{:<28} {:>10.1f}", "ns/move", time * 1000000000.0 / (passes * static_cast<f64>(boards.size())));
+            println("{:<28} {:>10.1f}", "ns/call", time * 1000000000.0 / (passes * static_cast<f64>(calls.size())));
+            println(
+                "{:<28} {:>10.2f}",
+                "threats/move",
+                static_cast<f64>(threatsPerPass) / static_cast<f64>(boards.size())
+            );
+
+            println();
+            println("threat checksum {:016x}", checksumPerPass);
+        }
+    }
+} // namespace stormphrax::eval::bench
@@ -0,0 +1,77 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../move.h"
+
+namespace stormphrax::eval::bench {
+    enum class OpType : u8 {
+        kPush,
+        kPop,
+        kEval,
+    };
+
+    struct TrajectoryOp {
+        OpType type;
+        Move move{}; // only valid for kPush
+    };
+
+    // A sequence of push/pop/evaluate operations on an NnueState, starting from a root position
+    struct Trajectory {
+        std::string fen;
+        std::vector<TrajectoryOp> ops{};
+    };
+
+    constexpr i32 kDefaultTrajectoryDepth = 6;
+    constexpr i32 kDefaultDatasetDepth = 1;
+
+    // Generates trajectories from the bench positions by walking a pseudo-search tree:
+    // a few moves per node (more at the root), qsearch-like capture chains at the leaves,
+    // and most but not all nodes evaluated. Deterministic for a given depth
+    [[nodiscard]] std::vector<Trajectory> generateTrajectories(i32 depth = kDefaultTrajectoryDepth);
+    // As above, from arbitrary root positions. Invalid FENs are skipped
+    [[nodiscard]] std::vector<Trajectory> generateTrajectories(std::span<const std::string> fens, i32 depth);
+
+    // Reads one root position per line. Anything after the FEN in common
+    // data formats (" | score | wdl", " [wdl]", ";...") is ignored
+    [[nodiscard]] std::optional<std::vector<std::string>> loadDataset(const std::string& path);
+
+    // One trajectory per line, "<fen>;<op> <op> ...", where an op is either
+    // a move in UCI notation (push), "-" (pop) or "e" (evaluate)
+    [[nodiscard]] bool saveTrajectories(const std::string& path, std::span<const Trajectory> trajectories);
+    [[nodiscard]] std::optional<std::vector<Trajectory>> loadTrajectories(const std::string& path);
+
+    void run(std::span<const Trajectory> trajectories);
+
+    // Replays the threat delta generation for every move in the trajectories on the
+    // compiled-in geometry backend. The checksum is backend independent, so running
+    // this across builds on the same trajectory file compares backends directly
+    void runThreats(std::span<const Trajectory> trajectories);
+
+    // Evaluates every position in the trajectories and writes which FT outputs were
+    // active for each perspective, in the format described in activations.h
+    [[nodiscard]] bool dumpActivations(std::span<const Trajectory> trajectories, const std::string& path);
+} // namespace stormphrax::eval::bench
@@ -31,8 +31,19 @@ namespace stormphrax::eval {
         kHorizontallyMirrored = 0x0002,
         kMergedKings = 0x0004,
         kPairwiseMul = 0x0008,
+        kCompactThreats = 0x0010,
     };
 
+    // With kCompactThreats, threat weights are stored as 4-bit values with an i16 scale per
+    // feature, instead of i8. Within each row, each pair of SIMD chunks of outputs is packed
+    // into one chunk of bytes, the first chunk in the low nibbles and the second in the high
+    // nibbles. That layout depends on the SIMD width, so such networks are only ever produced
+    // by preprocess/permute.cpp for a specific build. The scales follow the packed weights,
+    // padded so that the following parameters stay 64-byte aligned
+    [[nodiscard]] constexpr usize compactThreatScaleCount(usize threatFeatures) {
+        return (threatFeatures + 31) / 32 * 32;
+    }
+
     constexpr u16 kExpectedHeaderVersion = 1;
 
     struct __attribute__((packed)) NetworkHeader {
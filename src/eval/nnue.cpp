@@ -18,6 +18,7 @@
 
 #include "nnue.h"
 
+#include <bit>
 #include <cassert>
 #include <cstring>
 #include <fstream>
@@ -29,6 +30,7 @@
 #include "../attacks/attacks.h"
 #include "../util/align.h"
 #include "../util/memstream.h"
+#include "../util/multi_array.h"
 #include "../util/numa/numa.h"
 #include "header.h"
 #include "nnue/features/threats/geometry.h"
@@ -136,6 +138,28 @@ namespace stormphrax::eval {
                 return false;
             }
 
+            if (testFlags(header.flags, NetworkFlags::kCompactThreats) != FeatureTransformer::kCompactThreats) {
+                if constexpr (FeatureTransformer::kCompactThreats) {
+                    eprintln("network does not have compact threat weights, expected compact");
+                } else {
+                    eprintln("network has compact threat weights, expected normal (build with COMPACT_THREATS=on)");
+                }
+
+                return false;
+            }
+
+            if constexpr (FeatureTransformer::kCompactThreats) {
+                if constexpr (!InputFeatureSet::kThreatInputs) {
+                    eprintln("network has compact threat weights, but no threat inputs are expected");
+                    return false;
+                }
+
+                if (testFlags(header.flags, NetworkFlags::kZstdCompressed)) {
+                    eprintln("compressed networks cannot have compact threat weights");
+                    return false;
+                }
+            }
+
             if (header.activation != L1Activation::kId) {
                 eprintln(
                     "wrong l1 activation function {} (expected: {})",
@@ -185,16 +209,16 @@ namespace stormphrax::eval {
         }
 
         // must manually allocate for alignment
-        std::byte* s_loadedNetworkData{nullptr};
+        constinit std::byte* s_loadedNetworkData{nullptr};
 
 #ifdef SP_USE_LIBNUMA
-        std::unique_ptr<numa::NumaUniqueAllocation<std::byte>> s_networkData{};
-        std::unique_ptr<numa::NumaUniqueAllocation<Network>> s_networks{};
+        constinit std::unique_ptr<numa::NumaUniqueAllocation<std::byte>> s_networkData{};
+        constinit std::unique_ptr<numa::NumaUniqueAllocation<Network>> s_networks{};
 #else
-        Network s_network{};
+        constinit Network s_network{};
 #endif
 
-        bool s_networkLoaded{false};
+        constinit bool s_networkLoaded{false};
     } // namespace
 
     void init() {
@@ -210,9 +234,8 @@ namespace stormphrax::eval {
             return;
         }
 
-        const auto networkSize = Network::byteSize();
-
         const bool compressed = testFlags(header.flags, NetworkFlags::kZstdCompressed);
+        const auto networkSize = Network::byteSize();
 
         const std::byte* ptr;
 
@@ -329,13 +352,13 @@ namespace stormphrax::eval {
         namespace geometry = nnue::features::threats::geometry;
         using UpdatedThreat = nnue::features::psq::ThreatDescriptor;
 
-#if SP_HAS_VBMI2
         static_assert(sizeof(UpdatedThreat) == sizeof(u32));
         static_assert(offsetof(UpdatedThreat, attacker) == 0 * sizeof(u8));
         static_assert(offsetof(UpdatedThreat, attackerSq) == 1 * sizeof(u8));
         static_assert(offsetof(UpdatedThreat, attacked) == 2 * sizeof(u8));
         static_assert(offsetof(UpdatedThreat, attackedSq) == 3 * sizeof(u8));
 
+#if SP_HAS_VBMI2
         template <bool kAdd, bool kOutgoing>
         inline void pushFocusThreatFeatures(
             NnueUpdates& updates,
@@ -413,6 +436,292 @@ namespace stormphrax::eval {
                 });
             }
         }
+#elif SP_HAS_AVX512
+        // Without VBMI2 there is no byte compress, so each 16 square slice of the rays
+        // is widened to whole (piece, square, piece, square) tuples, which are then
+        // compressed as dwords and stored back to back.
+
+        // Widens 16 (piece, square) pairs to the low half of 16 tuples
+        inline __m512i widenPairs(__m128i pieces, __m128i squares) {
+            return _mm512_or_si512(
+                _mm512_cvtepu8_epi32(pieces),
+                _mm512_slli_epi32(_mm512_cvtepu8_epi32(squares), 8)
+            );
+        }
+
+        template <bool kOutgoing>
+        inline UpdatedThreat* storeFocusSlice(
+            UpdatedThreat* ptr,
+            __m512i focus,
+            __m128i pieces,
+            __m128i squares,
+            __mmask16 mask
+        ) {
+            // Whether the focus pair is the attacker or the victim is determined by kOutgoing.
+            const auto others = widenPairs(pieces, squares);
+            const auto tuples = kOutgoing ? _mm512_or_si512(focus, _mm512_slli_epi32(others, 16))
+                                          : _mm512_or_si512(others, _mm512_slli_epi32(focus, 16));
+
+            _mm512_storeu_si512(ptr, _mm512_maskz_compress_epi32(mask, tuples));
+            return ptr + std::popcount(mask);
+        }
+
+        template <bool kAdd, bool kOutgoing>
+        inline void pushFocusThreatFeatures(
+            NnueUpdates& updates,
+            geometry::Vector indexes, // List of square indexes
+            geometry::Vector rays,    // List of pieces on those squares as indexed by indexes
+            geometry::Bitrays br,     // Bitrays where bit set is a piece attacked/being attacked by focus square
+            Piece piece,              // Piece on the focus square
+            Square sq                 // The focus square
+        ) {
+            const auto focus = _mm512_set1_epi32(static_cast<i32>(piece.idx() | (sq.idx() << 8)));
+
+            // threatsAdded and threatsRemoved are constexpr without threat inputs
+            if constexpr (InputFeatureSet::kThreatInputs) {
+                (kAdd ? updates.threatsAdded : updates.threatsRemoved).unsafeWrite([&](UpdatedThreat* ptr) {
+                    auto* const begin = ptr;
+
+                    ptr = storeFocusSlice<kOutgoing>(
+                        ptr,
+                        focus,
+                        _mm512_extracti32x4_epi32(rays.raw, 0),
+                        _mm512_extracti32x4_epi32(indexes.raw, 0),
+                        static_cast<__mmask16>(br)
+                    );
+                    ptr = storeFocusSlice<kOutgoing>(
+                        ptr,
+                        focus,
+                        _mm512_extracti32x4_epi32(rays.raw, 1),
+                        _mm512_extracti32x4_epi32(indexes.raw, 1),
+                        static_cast<__mmask16>(br >> 16)
+                    );
+                    ptr = storeFocusSlice<kOutgoing>(
+                        ptr,
+                        focus,
+                        _mm512_extracti32x4_epi32(rays.raw, 2),
+                        _mm512_extracti32x4_epi32(indexes.raw, 2),
+                        static_cast<__mmask16>(br >> 32)
+                    );
+                    ptr = storeFocusSlice<kOutgoing>(
+                        ptr,
+                        focus,
+                        _mm512_extracti32x4_epi32(rays.raw, 3),
+                        _mm512_extracti32x4_epi32(indexes.raw, 3),
+                        static_cast<__mmask16>(br >> 48)
+                    );
+
+                    return ptr - begin;
+                });
+            }
+        }
+
+        // Every ray holds at most one slider, with its victim on the opposite ray,
+        // so compressing sliders and victims separately keeps them paired up
+        inline UpdatedThreat* storeDiscoveredSlice(
+            UpdatedThreat* ptr,
+            __m128i sliderPieces,
+            __m128i sliderSquares,
+            __m128i victimPieces,
+            __m128i victimSquares,
+            __mmask16 sliders,
+            __mmask16 victims
+        ) {
+            const auto attackers = _mm512_maskz_compress_epi32(sliders, widenPairs(sliderPieces, sliderSquares));
+            const auto attacked = _mm512_maskz_compress_epi32(victims, widenPairs(victimPieces, victimSquares));
+
+            _mm512_storeu_si512(ptr, _mm512_or_si512(attackers, _mm512_slli_epi32(attacked, 16)));
+            return ptr + std::popcount(sliders);
+        }
+
+        template <bool kAdd>
+        inline void pushDiscoveredThreatFeatures(
+            NnueUpdates& updates,
+            geometry::Vector indexes, // Squares
+            geometry::Vector rays,    // Pieces
+            geometry::Bitrays sliders,
+            geometry::Bitrays victims
+        ) {
+            assert(std::popcount(victims) == std::popcount(sliders));
+
+            // see above
+            if constexpr (InputFeatureSet::kThreatInputs) {
+                // Opposite polarity:
+                // - Adding focus piece removes x-ray threats (a.k.a. slider threat retraction)
+                // - Removing focus piece adds x-ray threats (a.k.a. slider threat extension)
+                (kAdd ? updates.threatsRemoved : updates.threatsAdded).unsafeWrite([&](UpdatedThreat* ptr) {
+                    auto* const begin = ptr;
+
+                    // victims are on the opposite rays, half a vector away
+                    ptr = storeDiscoveredSlice(
+                        ptr,
+                        _mm512_extracti32x4_epi32(rays.raw, 0),
+                        _mm512_extracti32x4_epi32(indexes.raw, 0),
+                        _mm512_extracti32x4_epi32(rays.raw, 2),
+                        _mm512_extracti32x4_epi32(indexes.raw, 2),
+                        static_cast<__mmask16>(sliders),
+                        static_cast<__mmask16>(victims)
+                    );
+                    ptr = storeDiscoveredSlice(
+                        ptr,
+                        _mm512_extracti32x4_epi32(rays.raw, 1),
+                        _mm512_extracti32x4_epi32(indexes.raw, 1),
+                        _mm512_extracti32x4_epi32(rays.raw, 3),
+                        _mm512_extracti32x4_epi32(indexes.raw, 3),
+                        static_cast<__mmask16>(sliders >> 16),
+                        static_cast<__mmask16>(victims >> 16)
+                    );
+                    ptr = storeDiscoveredSlice(
+                        ptr,
+                        _mm512_extracti32x4_epi32(rays.raw, 2),
+                        _mm512_extracti32x4_epi32(indexes.raw, 2),
+                        _mm512_extracti32x4_epi32(rays.raw, 0),
+                        _mm512_extracti32x4_epi32(indexes.raw, 0),
+                        static_cast<__mmask16>(sliders >> 32),
+                        static_cast<__mmask16>(victims >> 32)
+                    );
+                    ptr = storeDiscoveredSlice(
+                        ptr,
+                        _mm512_extracti32x4_epi32(rays.raw, 3),
+                        _mm512_extracti32x4_epi32(indexes.raw, 3),
+                        _mm512_extracti32x4_epi32(rays.raw, 1),
+                        _mm512_extracti32x4_epi32(indexes.raw, 1),
+                        static_cast<__mmask16>(sliders >> 48),
+                        static_cast<__mmask16>(victims >> 48)
+                    );
+
+                    return ptr - begin;
+                });
+            }
+        }
+#elif SP_HAS_AVX2
+        // AVX2 has no compress either, so each ray is widened to 8 tuples which are
+        // packed down with a cross-lane permute. Most rays have no threats on them
+        // and are skipped entirely
+
+        // Indices of the set bits in each byte, in ascending order
+        alignas(64) constexpr auto kCompressIndices = [] {
+            util::MultiArray<u8, 256, 8> indices{};
+
+            for (u32 mask = 0; mask < 256; ++mask) {
+                u32 count = 0;
+
+                for (u32 v = mask; v != 0; v &= v - 1) {
+                    indices[mask][count++] = std::countr_zero(v);
+                }
+            }
+
+            return indices;
+        }();
+
+        inline __m256i compressPermutation(u32 mask) {
+            const auto indices = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kCompressIndices[mask].data()));
+            return _mm256_cvtepu8_epi32(indices);
+        }
+
+        // Widens the 8 (piece, square) pairs of a ray to the low half of 8 tuples
+        inline __m256i widenPairs(u64 pieces, u64 squares) {
+            return _mm256_or_si256(
+                _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<i64>(pieces))),
+                _mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<i64>(squares))), 8)
+            );
+        }
+
+        template <bool kAdd, bool kOutgoing>
+        inline void pushFocusThreatFeatures(
+            NnueUpdates& updates,
+            geometry::Vector indexes, // List of square indexes
+            geometry::Vector rays,    // List of pieces on those squares as indexed by indexes
+            geometry::Bitrays br,     // Bitrays where bit set is a piece attacked/being attacked by focus square
+            Piece piece,              // Piece on the focus square
+            Square sq                 // The focus square
+        ) {
+            std::array<u64, 8> others;
+            std::memcpy(others.data(), &rays, sizeof(others));
+            std::array<u64, 8> otherSqs;
+            std::memcpy(otherSqs.data(), &indexes, sizeof(otherSqs));
+
+            const auto focus = _mm256_set1_epi32(static_cast<i32>(piece.idx() | (sq.idx() << 8)));
+
+            // threatsAdded and threatsRemoved are constexpr without threat inputs
+            if constexpr (InputFeatureSet::kThreatInputs) {
+                (kAdd ? updates.threatsAdded : updates.threatsRemoved).unsafeWrite([&](UpdatedThreat* ptr) {
+                    auto* const begin = ptr;
+
+                    for (u32 ray = 0; ray < 8; ++ray) {
+                        const auto mask = static_cast<u32>(br >> (ray * 8)) & 0xFF;
+
+                        if (mask == 0) {
+                            continue;
+                        }
+
+                        // Whether the focus pair is the attacker or the victim is determined by kOutgoing.
+                        const auto pairs = widenPairs(others[ray], otherSqs[ray]);
+                        const auto tuples = kOutgoing ? _mm256_or_si256(focus, _mm256_slli_epi32(pairs, 16))
+                                                      : _mm256_or_si256(pairs, _mm256_slli_epi32(focus, 16));
+
+                        const auto packed = _mm256_permutevar8x32_epi32(tuples, compressPermutation(mask));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), packed);
+
+                        ptr += std::popcount(mask);
+                    }
+
+                    return ptr - begin;
+                });
+            }
+        }
+
+        template <bool kAdd>
+        inline void pushDiscoveredThreatFeatures(
+            NnueUpdates& updates,
+            geometry::Vector indexes, // Squares
+            geometry::Vector rays,    // Pieces
+            geometry::Bitrays sliders,
+            geometry::Bitrays victims
+        ) {
+            assert(std::popcount(victims) == std::popcount(sliders));
+
+            std::array<u64, 8> pieces;
+            std::memcpy(pieces.data(), &rays, sizeof(pieces));
+            std::array<u64, 8> squares;
+            std::memcpy(squares.data(), &indexes, sizeof(squares));
+
+            // see above
+            if constexpr (InputFeatureSet::kThreatInputs) {
+                // Opposite polarity:
+                // - Adding focus piece removes x-ray threats (a.k.a. slider threat retraction)
+                // - Removing focus piece adds x-ray threats (a.k.a. slider threat extension)
+                (kAdd ? updates.threatsRemoved : updates.threatsAdded).unsafeWrite([&](UpdatedThreat* ptr) {
+                    auto* const begin = ptr;
+
+                    for (u32 ray = 0; ray < 8; ++ray) {
+                        const auto sliderMask = static_cast<u32>(sliders >> (ray * 8)) & 0xFF;
+
+                        if (sliderMask == 0) {
+                            continue;
+                        }
+
+                        // at most one slider per ray, with its victim on the opposite ray
+                        const auto victimMask = static_cast<u32>(victims >> (ray * 8)) & 0xFF;
+                        const auto opposite = (ray + 4) % 8;
+
+                        const auto attackers = _mm256_permutevar8x32_epi32(
+                            widenPairs(pieces[ray], squares[ray]),
+                            compressPermutation(sliderMask)
+                        );
+                        const auto attacked = _mm256_permutevar8x32_epi32(
+                            widenPairs(pieces[opposite], squares[opposite]),
+                            compressPermutation(victimMask)
+                        );
+
+                        const auto tuple = _mm256_or_si256(attackers, _mm256_slli_epi32(attacked, 16));
+                        *ptr++ = std::bit_cast<UpdatedThreat>(_mm256_cvtsi256_si32(tuple));
+                    }
+
+                    return ptr - begin;
+                });
+            }
+        }
 #else
         template <bool kAdd, bool kOutgoing>
         inline void pushFocusThreatFeatures(
@@ -32,6 +32,7 @@ namespace stormphrax::eval {
 
     using Accumulator = FeatureTransformer::Accumulator;
     using RefreshTable = FeatureTransformer::RefreshTable;
+    using RefreshTableStats = nnue::RefreshTableStats;
 
     using NnueUpdates = InputFeatureSet::Updates;
 
@@ -29,6 +29,7 @@
 #include "../../../util/simd.h"
 #include "../loader.h"
 #include "../output.h"
+#include "util/l1.h"
 #include "util/sparse.h"
 
 namespace stormphrax::eval::nnue::arch {
@@ -60,8 +61,6 @@ namespace stormphrax::eval::nnue::arch {
         static constexpr bool kRequiresFtPermute = util::simd::kPackNonSequential;
 
     private:
-        static constexpr auto kI8ChunkSizeI32 = sizeof(i32) / sizeof(u8);
-
         static constexpr u32 kL2SizeFull = kL2Size * (1 + kDualActivation);
 
         static_assert(!kSkipL2 || kL2SizeFull == kL3Size);
@@ -89,6 +88,9 @@ namespace stormphrax::eval::nnue::arch {
         static constexpr i32 kQuantBits = 6;
         static constexpr i32 kQ = 1 << kQuantBits;
 
+    public:
+        // individual layers are exposed for evalbench
+
         inline void activateFt(
             std::span<const i16, kL1Size> stmPsqInputs,
             std::span<const i16, kL1Size> nstmPsqInputs,
@@ -167,54 +169,9 @@ namespace stormphrax::eval::nnue::arch {
             // SAFETY: u8 (unsigned char) can safely be aliased to any type
             const auto* inI32s = reinterpret_cast<const i32*>(inputs.data());
 
-            SP_SIMD_ALIGNAS util::MultiArray<Vector<i32>, kL2Size / kChunkSize<i32>, 4> intermediate{};
-
-            const auto quadChunks = sparseCtx.count() - (sparseCtx.count() % 4);
-
-            for (usize chunk = 0; chunk < quadChunks; chunk += 4) {
-                const auto idx_0 = sparseCtx.chunk(chunk + 0);
-                const auto idx_1 = sparseCtx.chunk(chunk + 1);
-                const auto idx_2 = sparseCtx.chunk(chunk + 2);
-                const auto idx_3 = sparseCtx.chunk(chunk + 3);
+            SP_SIMD_ALIGNAS l1::Intermediate<kL2Size> intermediate{};
 
-                const auto ws_0 = weightOffset + idx_0 * kI8ChunkSizeI32 * kL2Size;
-                const auto ws_1 = weightOffset + idx_1 * kI8ChunkSizeI32 * kL2Size;
-                const auto ws_2 = weightOffset + idx_2 * kI8ChunkSizeI32 * kL2Size;
-                const auto ws_3 = weightOffset + idx_3 * kI8ChunkSizeI32 * kL2Size;
-
-                const auto i_0 = set1<i32>(inI32s[idx_0]);
-                const auto i_1 = set1<i32>(inI32s[idx_1]);
-                const auto i_2 = set1<i32>(inI32s[idx_2]);
-                const auto i_3 = set1<i32>(inI32s[idx_3]);
-
-                for (u32 outputIdx = 0; outputIdx < kL2Size; outputIdx += kChunkSize<i32>) {
-                    auto& v = intermediate[outputIdx / kChunkSize<i32>];
-
-                    const auto w_0 = load<i8>(&l1Weights[ws_0 + kI8ChunkSizeI32 * outputIdx]);
-                    const auto w_1 = load<i8>(&l1Weights[ws_1 + kI8ChunkSizeI32 * outputIdx]);
-                    const auto w_2 = load<i8>(&l1Weights[ws_2 + kI8ChunkSizeI32 * outputIdx]);
-                    const auto w_3 = load<i8>(&l1Weights[ws_3 + kI8ChunkSizeI32 * outputIdx]);
-
-                    v[0] = dpbusd<i32>(v[0], i_0, w_0);
-                    v[1] = dpbusd<i32>(v[1], i_1, w_1);
-                    v[2] = dpbusd<i32>(v[2], i_2, w_2);
-                    v[3] = dpbusd<i32>(v[3], i_3, w_3);
-                }
-            }
-
-            for (usize chunk = quadChunks; chunk < sparseCtx.count(); ++chunk) {
-                const auto idx = sparseCtx.chunk(chunk);
-
-                const auto ws = weightOffset + idx * kI8ChunkSizeI32 * kL2Size;
-
-                const auto i = set1<i32>(inI32s[idx]);
-
-                for (u32 outputIdx = 0; outputIdx < kL2Size; outputIdx += kChunkSize<i32>) {
-                    auto& v = intermediate[outputIdx / kChunkSize<i32>];
-                    const auto w = load<i8>(&l1Weights[ws + kI8ChunkSizeI32 * outputIdx]);
-                    v[0] = dpbusd<i32>(v[0], i, w);
-                }
-            }
+            l1::accumulateSparse<kL1Size, kL2Size>(&l1Weights[weightOffset], inI32s, sparseCtx, intermediate);
 
             for (u32 idx = 0; idx < kL2Size; idx += kChunkSize<i32>) {
                 const auto& v = intermediate[idx / kChunkSize<i32>];
@@ -446,7 +403,6 @@ namespace stormphrax::eval::nnue::arch {
             outputs[0] = l3Biases[biasOffset] + hsum<i32>(s);
         }
 
-    public:
         inline void propagate(
             u32 bucket,
             std::span<const i16, kL1Size> stmPsqInputs,
@@ -477,10 +433,6 @@ namespace stormphrax::eval::nnue::arch {
             propagateL2(bucket, l1Out, l2Out);
             propagateL3(bucket, l1Out, l2Out, l3Out);
 
-#if SP_SPARSE_BENCH_L1_SIZE > 0
-            sparse::trackActivations(ftOut);
-#endif
-
             auto out = static_cast<i64>(l3Out[0]);
 
             out *= kScale;
@@ -0,0 +1,37 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../../../../types.h"
+
+#include "../../../../arch.h"
+#include "../../../../util/multi_array.h"
+#include "../../../../util/simd.h"
+
+namespace stormphrax::eval::nnue::arch::l1 {
+    template <u32 kL2Size>
+    using Intermediate = util::MultiArray<util::simd::Vector<i32>, kL2Size / util::simd::kChunkSize<i32>, 4>;
+} // namespace stormphrax::eval::nnue::arch::l1
+
+// only included from here, and use Intermediate above
+#if SP_HAS_AVX2 && !SP_HAS_AVX512 && SP_HAS_VNNI256
+    #include "l1_vnni.h"
+#else
+    #include "l1_default.h"
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../../../../types.h"
+
+#include "../../../../util/multi_array.h"
+#include "../../../../util/simd.h"
+#include "sparse.h"
+
+namespace stormphrax::eval::nnue::arch::l1 {
+    // Accumulates the products of the nonzero 4-byte chunks of the activated FT
+    // outputs with their L1 weight rows. Callers sum the four partial accumulators
+    template <u32 kL1Size, u32 kL2Size>
+    SP_ALWAYS_INLINE_NDEBUG inline void accumulateSparse(
+        const i8* weights,
+        const i32* inputs,
+        const sparse::SparseContext<kL1Size>& sparseCtx,
+        Intermediate<kL2Size>& intermediate
+    ) {
+        using namespace util::simd;
+
+        static constexpr auto kI8ChunkSizeI32 = sizeof(i32) / sizeof(u8);
+
+        const auto quadChunks = sparseCtx.count() - (sparseCtx.count() % 4);
+
+        for (usize chunk = 0; chunk < quadChunks; chunk += 4) {
+            const auto idx_0 = sparseCtx.chunk(chunk + 0);
+            const auto idx_1 = sparseCtx.chunk(chunk + 1);
+            const auto idx_2 = sparseCtx.chunk(chunk + 2);
+            const auto idx_3 = sparseCtx.chunk(chunk + 3);
+
+            const auto ws_0 = idx_0 * kI8ChunkSizeI32 * kL2Size;
+            const auto ws_1 = idx_1 * kI8ChunkSizeI32 * kL2Size;
+            const auto ws_2 = idx_2 * kI8ChunkSizeI32 * kL2Size;
+            const auto ws_3 = idx_3 * kI8ChunkSizeI32 * kL2Size;
+
+            const auto i_0 = set1<i32>(inputs[idx_0]);
+            const auto i_1 = set1<i32>(inputs[idx_1]);
+            const auto i_2 = set1<i32>(inputs[idx_2]);
+            const auto i_3 = set1<i32>(inputs[idx_3]);
+
+            for (u32 outputIdx = 0; outputIdx < kL2Size; outputIdx += kChunkSize<i32>) {
+                auto& v = intermediate[outputIdx / kChunkSize<i32>];
+
+                const auto w_0 = load<i8>(&weights[ws_0 + kI8ChunkSizeI32 * outputIdx]);
+                const auto w_1 = load<i8>(&weights[ws_1 + kI8ChunkSizeI32 * outputIdx]);
+                const auto w_2 = load<i8>(&weights[ws_2 + kI8ChunkSizeI32 * outputIdx]);
+                const auto w_3 = load<i8>(&weights[ws_3 + kI8ChunkSizeI32 * outputIdx]);
+
+                v[0] = dpbusd<i32>(v[0], i_0, w_0);
+                v[1] = dpbusd<i32>(v[1], i_1, w_1);
+                v[2] = dpbusd<i32>(v[2], i_2, w_2);
+                v[3] = dpbusd<i32>(v[3], i_3, w_3);
+            }
+        }
+
+        for (usize chunk = quadChunks; chunk < sparseCtx.count(); ++chunk) {
+            const auto idx = sparseCtx.chunk(chunk);
+
+            const auto ws = idx * kI8ChunkSizeI32 * kL2Size;
+
+            const auto i = set1<i32>(inputs[idx]);
+
+            for (u32 outputIdx = 0; outputIdx < kL2Size; outputIdx += kChunkSize<i32>) {
+                auto& v = intermediate[outputIdx / kChunkSize<i32>];
+                const auto w = load<i8>(&weights[ws + kI8ChunkSizeI32 * outputIdx]);
+                v[0] = dpbusd<i32>(v[0], i, w);
+            }
+        }
+    }
+} // namespace stormphrax::eval::nnue::arch::l1
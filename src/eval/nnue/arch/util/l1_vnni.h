@@ -0,0 +1,93 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../../../../types.h"
+
+#include <immintrin.h>
+
+#include "../../../../util/multi_array.h"
+#include "../../../../util/simd.h"
+#include "sparse.h"
+
+namespace stormphrax::eval::nnue::arch::l1 {
+    namespace internal {
+        // vpdpbusd directly, rather than through the generic wrapper, so
+        // that this kernel can never silently fall back to maddubs+madd
+        SP_ALWAYS_INLINE_NDEBUG inline util::simd::VectorI32 dpbusd(
+            util::simd::VectorI32 sum,
+            util::simd::VectorU8 u,
+            util::simd::VectorI8 i
+        ) {
+            return _mm256_dpbusd_avx_epi32(sum, u, i);
+        }
+    } // namespace internal
+
+    // AVX-VNNI variant of the generic sparse L1 kernel, only used by the opt-in avx2-vnni build.
+    // Each of the four chunks in an iteration has its own accumulator, so the vpdpbusd chains
+    // stay independent; callers sum the four partial accumulators
+    template <u32 kL1Size, u32 kL2Size>
+    SP_ALWAYS_INLINE_NDEBUG inline void accumulateSparse(
+        const i8* weights,
+        const i32* inputs,
+        const sparse::SparseContext<kL1Size>& sparseCtx,
+        Intermediate<kL2Size>& intermediate
+    ) {
+        using namespace util::simd;
+
+        static constexpr auto kI8ChunkSizeI32 = sizeof(i32) / sizeof(u8);
+        static constexpr usize kRowStride = kI8ChunkSizeI32 * kL2Size;
+
+        const auto count = sparseCtx.count();
+        const auto quadChunks = count - (count % 4);
+
+        for (usize chunk = 0; chunk < quadChunks; chunk += 4) {
+            const auto idx_0 = sparseCtx.chunk(chunk + 0);
+            const auto idx_1 = sparseCtx.chunk(chunk + 1);
+            const auto idx_2 = sparseCtx.chunk(chunk + 2);
+            const auto idx_3 = sparseCtx.chunk(chunk + 3);
+
+            const auto i_0 = set1<i32>(inputs[idx_0]);
+            const auto i_1 = set1<i32>(inputs[idx_1]);
+            const auto i_2 = set1<i32>(inputs[idx_2]);
+            const auto i_3 = set1<i32>(inputs[idx_3]);
+
+            for (u32 outputIdx = 0; outputIdx < kL2Size; outputIdx += kChunkSize<i32>) {
+                auto& v = intermediate[outputIdx / kChunkSize<i32>];
+
+                const auto offset = kI8ChunkSizeI32 * outputIdx;
+
+                v[0] = internal::dpbusd(v[0], i_0, load<i8>(&weights[idx_0 * kRowStride + offset]));
+                v[1] = internal::dpbusd(v[1], i_1, load<i8>(&weights[idx_1 * kRowStride + offset]));
+                v[2] = internal::dpbusd(v[2], i_2, load<i8>(&weights[idx_2 * kRowStride + offset]));
+                v[3] = internal::dpbusd(v[3], i_3, load<i8>(&weights[idx_3 * kRowStride + offset]));
+            }
+        }
+
+        for (usize chunk = quadChunks; chunk < count; ++chunk) {
+            const auto idx = sparseCtx.chunk(chunk);
+            const auto i = set1<i32>(inputs[idx]);
+
+            for (u32 outputIdx = 0; outputIdx < kL2Size; outputIdx += kChunkSize<i32>) {
+                auto& v = intermediate[outputIdx / kChunkSize<i32>];
+                v[0] = internal::dpbusd(v[0], i, load<i8>(&weights[idx * kRowStride + kI8ChunkSizeI32 * outputIdx]));
+            }
+        }
+    }
+} // namespace stormphrax::eval::nnue::arch::l1
@@ -20,27 +20,10 @@
 
 #include "../../../../types.h"
 
-#include <array>
-
 #include "../../../../arch.h"
 
-#define SP_SPARSE_BENCH_L1_SIZE 0
-
 #if SP_HAS_AVX512 && SP_HAS_VBMI2
     #include "sparse_vbmi2.h"
 #else
     #include "sparse_default.h"
 #endif
-
-namespace stormphrax::eval::nnue::arch::sparse {
-#if SP_SPARSE_BENCH_L1_SIZE > 0
-    inline std::array<usize, SP_SPARSE_BENCH_L1_SIZE / 2> g_activationCounts{};
-    inline void trackActivations(std::span<const u8, SP_SPARSE_BENCH_L1_SIZE> ftActivations) {
-        for (usize i = 0; i < SP_SPARSE_BENCH_L1_SIZE; ++i) {
-            if (ftActivations[i] != 0) {
-                ++g_activationCounts[i % (SP_SPARSE_BENCH_L1_SIZE / 2)];
-            }
-        }
-    }
-#endif
-} // namespace stormphrax::eval::nnue::arch::sparse
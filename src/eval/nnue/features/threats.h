@@ -34,10 +34,14 @@ namespace stormphrax::eval::nnue::features::threats {
     // just in case
     constexpr usize kMaxThreatsAdded = 128;
     constexpr usize kMaxThreatsRemoved = 128;
+    // active threat features in a single position
+    constexpr usize kMaxThreatFeatures = 256;
 
     using AddedThreatList = StaticVector<psq::ThreatDescriptor, kMaxThreatsAdded>;
     using RemovedThreatList = StaticVector<psq::ThreatDescriptor, kMaxThreatsRemoved>;
 
+    using ThreatFeatureList = StaticVector<u16, kMaxThreatFeatures>;
+
     template <typename PsqFeatureSet>
     struct ThreatInputs : PsqFeatureSet {
         static constexpr bool kThreatInputs = true;
@@ -143,6 +143,8 @@ namespace stormphrax::eval::nnue::features::threats::geometry {
 
 #if SP_HAS_VBMI
     #include "geometry_vbmi.h"
+#elif SP_HAS_AVX512
+    #include "geometry_avx512.h"
 #elif SP_HAS_AVX2
     #include "geometry_avx2.h"
 #elif SP_HAS_NEON
@@ -22,11 +22,14 @@
 
 #include <array>
 #include <bit>
+#include <string_view>
 #include <tuple>
 
 #include <immintrin.h>
 
 namespace stormphrax::eval::nnue::features::threats::geometry {
+    constexpr std::string_view kBackendName = "avx2";
+
     struct Vector {
         std::array<__m256i, 2> raw;
 
@@ -0,0 +1,122 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../../../../types.h"
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <tuple>
+
+#include <immintrin.h>
+
+namespace stormphrax::eval::nnue::features::threats::geometry {
+    constexpr std::string_view kBackendName = "avx512";
+
+    struct Vector {
+        __m512i raw;
+
+        [[nodiscard]] Vector flip() const {
+            return {_mm512_shuffle_i64x2(raw, raw, 0b01001110)};
+        }
+    };
+
+    // Without VBMI there is no full-width byte permute, so each 16-byte lane of the
+    // mailbox is broadcast and shuffled separately, then blended on bits 4 and 5
+    // of the index. Those blend masks only depend on the focus square
+    struct Permutation {
+        Vector indexes;
+        Bitrays valid;
+        Bitrays oddLanes;
+        Bitrays highLanes;
+    };
+
+    [[nodiscard]] inline Permutation permutationFor(Square focus) {
+        const auto indexes = _mm512_loadu_si512(kPermutationTable[focus.idx()].data());
+        const auto valid = _mm512_testn_epi8_mask(indexes, _mm512_set1_epi8(0x80));
+        const auto oddLanes = _mm512_test_epi8_mask(indexes, _mm512_set1_epi8(0x10));
+        const auto highLanes = _mm512_test_epi8_mask(indexes, _mm512_set1_epi8(0x20));
+        return Permutation{{indexes}, valid, oddLanes, highLanes};
+    }
+
+    [[nodiscard]] inline std::tuple<Vector, Vector> permuteMailbox(const Permutation& permutation, __m512i mailbox) {
+        const auto lut =
+            _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kPieceToBitTable.data())));
+
+        const auto idxs = permutation.indexes.raw;
+
+        const auto lane0 = _mm512_shuffle_i64x2(mailbox, mailbox, 0b00000000);
+        const auto lane1 = _mm512_shuffle_i64x2(mailbox, mailbox, 0b01010101);
+        const auto lane2 = _mm512_shuffle_i64x2(mailbox, mailbox, 0b10101010);
+        const auto lane3 = _mm512_shuffle_i64x2(mailbox, mailbox, 0b11111111);
+
+        const auto low = _mm512_mask_shuffle_epi8(_mm512_shuffle_epi8(lane0, idxs), permutation.oddLanes, lane1, idxs);
+        const auto high = _mm512_mask_shuffle_epi8(_mm512_shuffle_epi8(lane2, idxs), permutation.oddLanes, lane3, idxs);
+
+        const auto permuted = _mm512_mask_blend_epi8(permutation.highLanes, low, high);
+        const auto bits = _mm512_maskz_shuffle_epi8(permutation.valid, lut, permuted);
+        return {{permuted}, {bits}};
+    }
+
+    [[nodiscard]] inline std::tuple<Vector, Vector> permuteMailbox(
+        const Permutation& permutation,
+        const std::span<const Piece, Squares::kCount> mailbox
+    ) {
+        return permuteMailbox(permutation, _mm512_loadu_si512(mailbox.data()));
+    }
+
+    [[nodiscard]] inline std::tuple<Vector, Vector> permuteMailbox(
+        const Permutation& permutation,
+        const std::span<const Piece, Squares::kCount> mailbox,
+        Square ignore
+    ) {
+        const auto maskedMailbox = _mm512_mask_blend_epi8(
+            ignore.bit(),
+            _mm512_loadu_si512(mailbox.data()),
+            _mm512_set1_epi8(Pieces::kNone.idx())
+        );
+        return permuteMailbox(permutation, maskedMailbox);
+    }
+
+    [[nodiscard]] inline Bitrays closestOccupied(Vector bits) {
+        const Bitrays occupied = _mm512_test_epi8_mask(bits.raw, bits.raw);
+        const Bitrays o = occupied | 0x8181818181818181;
+        return (o ^ (o - 0x0303030303030303)) & occupied;
+    }
+
+    [[nodiscard]] inline Bitrays rayFill(Bitrays br) {
+        br = (br + 0x7E7E7E7E7E7E7E7E) & 0x8080808080808080;
+        return br - (br >> 7);
+    }
+
+    [[nodiscard]] inline Bitrays outgoingThreats(Piece piece, Bitrays closest) {
+        return kOutgoingThreatsTable[piece.idx()] & closest;
+    }
+
+    [[nodiscard]] inline Bitrays incomingAttackers(Vector bits, Bitrays closest) {
+        const auto mask = _mm512_loadu_si512(kIncomingThreatsMask.data());
+        return _mm512_test_epi8_mask(bits.raw, mask) & closest;
+    }
+
+    [[nodiscard]] inline Bitrays incomingSliders(Vector bits, Bitrays closest) {
+        const auto mask = _mm512_loadu_si512(kIncomingSlidersMask.data());
+        return _mm512_test_epi8_mask(bits.raw, mask) & closest & 0xFEFEFEFEFEFEFEFE;
+    }
+} // namespace stormphrax::eval::nnue::features::threats::geometry
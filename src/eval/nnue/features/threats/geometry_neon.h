@@ -22,11 +22,14 @@
 
 #include <array>
 #include <span>
+#include <string_view>
 #include <tuple>
 
 #include <arm_neon.h>
 
 namespace stormphrax::eval::nnue::features::threats::geometry {
+    constexpr std::string_view kBackendName = "neon";
+
     struct Vector {
         uint8x16x4_t raw;
 
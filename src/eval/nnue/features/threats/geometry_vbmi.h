@@ -22,11 +22,14 @@
 
 #include <array>
 #include <span>
+#include <string_view>
 #include <tuple>
 
 #include <immintrin.h>
 
 namespace stormphrax::eval::nnue::features::threats::geometry {
+    constexpr std::string_view kBackendName = "vbmi";
+
     struct Vector {
         __m512i raw;
 
@@ -22,12 +22,15 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <span>
+#include <vector>
 
 #include "../../core.h"
 #include "../../position.h"
 #include "../../util/multi_array.h"
 #include "../../util/simd.h"
+#include "../header.h"
 #include "features/psq.h"
 #include "features/threats.h"
 #include "loader.h"
@@ -74,6 +77,11 @@ namespace stormphrax::eval::nnue {
             std::ranges::copy(featureTransformer.biases, m_outputs[1].begin());
         }
 
+        inline void init(const Ft& featureTransformer, Color c) {
+            assert(c != Colors::kNone);
+            std::ranges::copy(featureTransformer.biases, m_outputs[c.idx()].begin());
+        }
+
         inline void subAddFrom(const Accumulator& src, const Ft& featureTransformer, Color c, u32 sub, u32 add) {
             assert(sub < kInputCount);
             assert(add < kInputCount);
@@ -310,21 +318,123 @@ namespace stormphrax::eval::nnue {
         Acc accumulator{};
         std::array<BitboardSet, 2> bbs{};
 
+        // each perspective's half of an entry is keyed and aged separately
+        std::array<u32, 2> keys{};
+        std::array<u64, 2> lastUsed{};
+
         [[nodiscard]] BitboardSet& colorBbs(Color c) {
             return bbs[c.idx()];
         }
     };
 
-    template <typename Ft, u32 kSize>
-    struct RefreshTable {
-        std::array<RefreshTableEntry<Accumulator<Ft>>, kSize> table{};
+    struct RefreshTableStats {
+        usize bytes;
+        u64 lookups;
+        u64 hits;
+    };
+
+    // Caches an accumulator per perspective for each (king bucket, mirror) key, so a refresh
+    // only has to apply the difference from the last position seen with the same key.
+    // By default there is a slot for every key. With fewer, each perspective evicts its least
+    // recently used slot when it needs a new key, trading more expensive refreshes for a
+    // smaller per-thread footprint
+    template <typename Ft, u32 kKeyCount>
+    class RefreshTable {
+    public:
+        using Entry = RefreshTableEntry<Accumulator<Ft>>;
+
+        static constexpr u32 kMaxSize = kKeyCount;
+
+        // Clears the table, resizing it to the given number of slots (0 for one per key)
+        inline void init(const Ft& featureTransformer, u32 size) {
+            if (size == 0 || size > kMaxSize) {
+                size = kMaxSize;
+            }
+
+            if (m_entries.size() != size) {
+                m_entries.clear();
+                m_entries.resize(size);
+                m_entries.shrink_to_fit();
+            }
+
+            const bool direct = size == kMaxSize;
+
+            for (u32 idx = 0; idx < size; ++idx) {
+                auto& entry = m_entries[idx];
 
-        inline void init(const Ft& featureTransformer) {
-            for (auto& entry : table) {
                 entry.accumulator.initBoth(featureTransformer);
                 entry.bbs.fill(BitboardSet{});
+
+                entry.keys.fill(direct ? idx : kKeyCount);
+                entry.lastUsed.fill(0);
+            }
+
+            m_clock = 0;
+        }
+
+        [[nodiscard]] inline bool initialized() const {
+            return !m_entries.empty();
+        }
+
+        [[nodiscard]] inline Entry& find(const Ft& featureTransformer, Color c, u32 key) {
+            assert(c != Colors::kNone);
+            assert(key < kKeyCount);
+            assert(initialized());
+
+            const auto cIdx = c.idx();
+
+            ++m_clock;
+            ++m_lookups;
+
+            if (m_entries.size() == kMaxSize) {
+                auto& entry = m_entries[key];
+
+                if (entry.lastUsed[cIdx] != 0) {
+                    ++m_hits;
+                }
+
+                entry.lastUsed[cIdx] = m_clock;
+                return entry;
             }
+
+            auto* victim = &m_entries[0];
+
+            for (auto& entry : m_entries) {
+                if (entry.keys[cIdx] == key) {
+                    ++m_hits;
+                    entry.lastUsed[cIdx] = m_clock;
+                    return entry;
+                }
+
+                if (entry.lastUsed[cIdx] < victim->lastUsed[cIdx]) {
+                    victim = &entry;
+                }
+            }
+
+            victim->accumulator.init(featureTransformer, c);
+            victim->colorBbs(c) = BitboardSet{};
+
+            victim->keys[cIdx] = key;
+            victim->lastUsed[cIdx] = m_clock;
+
+            return *victim;
+        }
+
+        [[nodiscard]] inline RefreshTableStats stats() const {
+            return {
+                .bytes = m_entries.size() * sizeof(Entry),
+                .lookups = m_lookups,
+                .hits = m_hits,
+            };
         }
+
+    private:
+        std::vector<Entry> m_entries{};
+
+        u64 m_clock{};
+
+        u64 m_lookups{};
+        u64 m_hits{};
     };
 
     template <typename Type, typename ThreatType, u32 kOutputs, typename FeatureSet>
@@ -345,6 +455,16 @@ namespace stormphrax::eval::nnue {
         static constexpr auto kThreatWeightCount = FeatureSet::kThreatFeatures * kOutputCount;
         static constexpr auto kBiasCount = kOutputCount;
 
+        // see NetworkFlags::kCompactThreats, only supported by builds with COMPACT_THREATS=on
+#ifdef SP_COMPACT_THREATS
+        static constexpr bool kCompactThreats = true;
+#else
+        static constexpr bool kCompactThreats = false;
+#endif
+
+        static constexpr auto kCompactThreatWeightCount = kThreatWeightCount / 2;
+        static constexpr auto kThreatScaleCount = compactThreatScaleCount(FeatureSet::kThreatFeatures);
+
         static_assert(kPsqInputCount > 0);
         static_assert(kOutputCount > 0);
 
@@ -352,17 +472,44 @@ namespace stormphrax::eval::nnue {
         SP_NETWORK_PARAMS(ThreatWeightType, kThreatWeightCount, threatWeights);
         SP_NETWORK_PARAMS(OutputType, kBiasCount, biases);
 
+        // only loaded with kCompactThreats, in place of threatWeights
+        SP_NETWORK_PARAMS(i8, kCompactThreatWeightCount, compactThreatWeights);
+        SP_NETWORK_PARAMS(i16, kThreatScaleCount, threatScales);
+
         [[nodiscard]] inline const ThreatWeightType* threatWeightPtr(u32 featureIdx) const {
             return &threatWeights[featureIdx * kOutputCount];
         }
 
+        [[nodiscard]] inline const i8* compactThreatWeightPtr(u32 featureIdx) const {
+            return &compactThreatWeights[featureIdx * (kOutputCount / 2)];
+        }
+
+        [[nodiscard]] inline i16 threatScale(u32 featureIdx) const {
+            return threatScales[featureIdx];
+        }
+
         inline bool loadFrom(NetworkLoader& loader) {
-            return loader.load(psqWeights) && loader.load(threatWeights) && loader.load(biases);
+            if (!loader.load(psqWeights)) {
+                return false;
+            }
+
+            if constexpr (kCompactThreats) {
+                if (!loader.load(compactThreatWeights) || !loader.load(threatScales)) {
+                    return false;
+                }
+            } else if (!loader.load(threatWeights)) {
+                return false;
+            }
+
+            return loader.load(biases);
         }
 
-        [[nodiscard]] static inline usize byteSize() {
-            return sizeof(PsqWeightType) * kPsqWeightCount       //
-                 + sizeof(ThreatWeightType) * kThreatWeightCount //
+        [[nodiscard]] static constexpr usize byteSize() {
+            constexpr auto kThreatBytes = kCompactThreats ? kCompactThreatWeightCount + sizeof(i16) * kThreatScaleCount
+                                             : sizeof(ThreatWeightType) * kThreatWeightCount;
+
+            return sizeof(PsqWeightType) * kPsqWeightCount //
+                 + kThreatBytes                            //
                  + sizeof(OutputType) * kBiasCount;
         }
     };
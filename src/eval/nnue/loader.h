@@ -66,7 +66,7 @@ namespace stormphrax::eval::nnue {
     };
 
     template <typename T, usize kSize>
-    [[nodiscard]] static std::span<const T, kSize> nullSpan() {
+    [[nodiscard]] static constexpr std::span<const T, kSize> nullSpan() {
         return std::span<const T, kSize>{static_cast<const T*>(nullptr), kSize};
     }
 } // namespace stormphrax::eval::nnue
@@ -20,6 +20,7 @@
 
 #include "../../types.h"
 
+#include <cassert>
 #include <span>
 
 #include "../../position.h"
@@ -35,6 +36,10 @@ namespace stormphrax::eval::nnue {
             return m_featureTransformer;
         }
 
+        [[nodiscard]] inline const Arch& arch() const {
+            return m_arch;
+        }
+
         inline util::simd::Array<typename Arch::OutputType, Arch::kOutputCount> propagate(
             const Position& pos,
             std::span<const typename FeatureTransformer::OutputType, FeatureTransformer::kOutputCount> stmPsqInputs,
@@ -55,6 +60,9 @@ namespace stormphrax::eval::nnue {
                 return false;
             }
 
+            // compact threat weights are only ever written pre-permuted
+            assert(!FeatureTransformer::kCompactThreats || prePermuted);
+
             if (Arch::kRequiresFtPermute && !prePermuted) {
                 Arch::template permuteFt<
                     typename Ft::PsqWeightType,
@@ -124,17 +124,52 @@ namespace stormphrax::eval {
                     }
                 }
 
-                for (const auto index : subIndices) {
-                    const auto* sub = ft.threatWeightPtr(index);
-                    for (usize t = 0; t < kTile; ++t) {
-                        v[t] = simd::sub<i16>(v[t], simd::widenLoadI8ToI16(&sub[(base + t) * kChunk]));
+                if constexpr (FeatureTransformer::kCompactThreats) {
+                    static_assert(kTile % 2 == 0);
+
+                    // see NetworkFlags::kCompactThreats
+                    const auto unpack = [&](u32 index, usize t, simd::Vector<i16>& lo, simd::Vector<i16>& hi) {
+                        const auto* row = ft.compactThreatWeightPtr(index);
+                        const auto packed = simd::widenLoadI8ToI16(&row[(base + t) / 2 * kChunk]);
+                        const auto scale = simd::set1<i16>(ft.threatScale(index));
+
+                        lo = simd::shiftRight<i16>(simd::shiftLeft<i16>(packed, 12), 12);
+                        hi = simd::shiftRight<i16>(packed, 4);
+
+                        lo = simd::mulLo<i16>(lo, scale);
+                        hi = simd::mulLo<i16>(hi, scale);
+                    };
+
+                    for (const auto index : subIndices) {
+                        for (usize t = 0; t < kTile; t += 2) {
+                            simd::Vector<i16> lo, hi;
+                            unpack(index, t, lo, hi);
+                            v[t + 0] = simd::sub<i16>(v[t + 0], lo);
+                            v[t + 1] = simd::sub<i16>(v[t + 1], hi);
+                        }
+                    }
+
+                    for (const auto index : addIndices) {
+                        for (usize t = 0; t < kTile; t += 2) {
+                            simd::Vector<i16> lo, hi;
+                            unpack(index, t, lo, hi);
+                            v[t + 0] = simd::add<i16>(v[t + 0], lo);
+                            v[t + 1] = simd::add<i16>(v[t + 1], hi);
+                        }
+                    }
+                } else {
+                    for (const auto index : subIndices) {
+                        const auto* sub = ft.threatWeightPtr(index);
+                        for (usize t = 0; t < kTile; ++t) {
+                            v[t] = simd::sub<i16>(v[t], simd::widenLoadI8ToI16(&sub[(base + t) * kChunk]));
+                        }
                     }
-                }
 
-                for (const auto index : addIndices) {
-                    const auto* add = ft.threatWeightPtr(index);
-                    for (usize t = 0; t < kTile; ++t) {
-                        v[t] = simd::add<i16>(v[t], simd::widenLoadI8ToI16(&add[(base + t) * kChunk]));
+                    for (const auto index : addIndices) {
+                        const auto* add = ft.threatWeightPtr(index);
+                        for (usize t = 0; t < kTile; ++t) {
+                            v[t] = simd::add<i16>(v[t], simd::widenLoadI8ToI16(&add[(base + t) * kChunk]));
+                        }
                     }
                 }
 
@@ -306,14 +341,11 @@ namespace stormphrax::eval {
 #endif
         }
 
-        void addThreatFeatures(const Network& network, std::span<i16, kL1Size> acc, Color c, const Position& pos) {
+        void collectThreatFeatures(Color c, const Position& pos, nnue::features::threats::ThreatFeatureList& indices) {
             using namespace nnue::features::threats;
 
-            const auto& ft = network.featureTransformer();
             const auto kingSq = pos.king(c);
 
-            StaticVector<u16, 256> indices;
-
             const auto occ = pos.occ();
             const auto kings = pos.bb(PieceTypes::kKing);
 
@@ -350,7 +382,13 @@ namespace stormphrax::eval {
                 }
             }
 
-            applyThreatRows<true>(acc, ft, indices, std::span<const u16>{});
+        }
+
+        void addThreatFeatures(const Network& network, std::span<i16, kL1Size> acc, Color c, const Position& pos) {
+            nnue::features::threats::ThreatFeatureList indices;
+            collectThreatFeatures(c, pos, indices);
+
+            applyThreatRows<true>(acc, network.featureTransformer(), indices, std::span<const u16>{});
         }
 
         void applyThreatUpdates(const Network& network, UpdatableAccumulator& curr, const UpdateContext& ctx, Color c) {
@@ -465,9 +503,9 @@ namespace stormphrax::eval {
             const auto& bbs = pos.bbs();
 
             const auto kingSq = pos.king(c);
-            const auto tableIdx = InputFeatureSet::getRefreshTableEntry(c, kingSq);
+            const auto tableKey = InputFeatureSet::getRefreshTableEntry(c, kingSq);
 
-            auto& rtEntry = refreshTable.table[tableIdx];
+            auto& rtEntry = refreshTable.find(network.featureTransformer(), c, tableKey);
             auto& prevBbs = rtEntry.colorBbs(c);
 
             StaticVector<u32, 32> adds;
@@ -527,10 +565,58 @@ namespace stormphrax::eval {
             const Network& network,
             UpdatableAccumulator& accumulator,
             Color c,
-            const Position& pos
+            const Position& pos,
+            ThreatRefreshTable& refreshTable
         ) {
             if constexpr (InputFeatureSet::kThreatInputs) {
-                resetThreatAccumulator(network, accumulator.threatAcc[0], c, pos);
+                using namespace nnue::features::threats;
+
+                const auto& ft = network.featureTransformer();
+
+                auto& rtEntry = refreshTable[c.idx()][pos.king(c).file() >= kFileE];
+                const auto& prevFeatures = rtEntry.features;
+
+                ThreatFeatureList features;
+                collectThreatFeatures(c, pos, features);
+                std::ranges::sort(features);
+
+                ThreatFeatureList adds;
+                ThreatFeatureList subs;
+
+                // both lists are sorted, so a single merge finds the difference
+                usize curr = 0;
+                usize prev = 0;
+
+                while (curr < features.size() && prev < prevFeatures.size()) {
+                    if (features[curr] < prevFeatures[prev]) {
+                        adds.push(features[curr++]);
+                    } else if (prevFeatures[prev] < features[curr]) {
+                        subs.push(prevFeatures[prev++]);
+                    } else {
+                        ++curr;
+                        ++prev;
+                    }
+                }
+
+                for (; curr < features.size(); ++curr) {
+                    adds.push(features[curr]);
+                }
+
+                for (; prev < prevFeatures.size(); ++prev) {
+                    subs.push(prevFeatures[prev]);
+                }
+
+                // rebuild outright if that touches fewer rows than the diff
+                if (!rtEntry.valid || adds.size() + subs.size() >= features.size()) {
+                    applyThreatRows<true>(rtEntry.accumulator, ft, features, std::span<const u16>{});
+                } else {
+                    applyThreatRows(rtEntry.accumulator, ft, adds, subs);
+                }
+
+                rtEntry.features = features;
+                rtEntry.valid = true;
+
+                std::ranges::copy(rtEntry.accumulator, accumulator.threatAcc[0].forColor(c).begin());
                 accumulator.setThreatUpdated(c);
             }
         }
@@ -539,23 +625,25 @@ namespace stormphrax::eval {
     void NnueState::reset(const Position& pos) {
         assert(m_network);
 
-        m_refreshTable.init(m_network->featureTransformer());
+        // cached accumulators stay valid across positions, so only
+        // clear the refresh table when the network or size changes
+        if (!m_refreshTable.initialized() || m_refreshTableNetwork != m_network) {
+            m_refreshTable.init(m_network->featureTransformer(), m_refreshTableSize);
+            m_refreshTableNetwork = m_network;
+
+            for (auto& perspective : m_threatRefreshTable) {
+                for (auto& entry : perspective) {
+                    entry.valid = false;
+                }
+            }
+        }
 
         m_top = &m_accumulatorStack[0];
 
         for (const auto c : {Colors::kBlack, Colors::kWhite}) {
-            const auto king = pos.king(c);
-            const auto entry = InputFeatureSet::getRefreshTableEntry(c, king);
-
-            auto& rtEntry = m_refreshTable.table[entry];
-            resetPsqAccumulator(*m_network, rtEntry.accumulator, c, pos);
-
-            m_top->psqAcc.copyFrom(c, rtEntry.accumulator);
-            rtEntry.colorBbs(c) = pos.bbs();
+            refreshPsqAccumulator(*m_network, *m_top, c, pos, m_refreshTable);
 
-            if constexpr (InputFeatureSet::kThreatInputs) {
-                resetThreatAccumulator(*m_network, m_top->threatAcc[0], c, pos);
-            }
+            refreshThreatAccumulator(*m_network, *m_top, c, pos, m_threatRefreshTable);
         }
     }
 
@@ -582,7 +670,7 @@ namespace stormphrax::eval {
 
             if constexpr (InputFeatureSet::kThreatInputs) {
                 if (ctx.updates.requiresThreatRefresh(c)) {
-                    refreshThreatAccumulator(*m_network, *m_top, c, pos);
+                    refreshThreatAccumulator(*m_network, *m_top, c, pos, m_threatRefreshTable);
                 } else {
                     applyThreatUpdates(*m_network, *m_top, ctx, c);
                 }
@@ -633,6 +721,16 @@ namespace stormphrax::eval {
         }
     }
 
+    void NnueState::refreshPsq(const Position& pos, Color c) {
+        assert(m_network);
+        refreshPsqAccumulator(*m_network, *m_top, c, pos, m_refreshTable);
+    }
+
+    void NnueState::refreshThreats(const Position& pos, Color c) {
+        assert(m_network);
+        refreshThreatAccumulator(*m_network, *m_top, c, pos, m_threatRefreshTable);
+    }
+
     void NnueState::ensureUpToDate(const Position& pos) {
         assert(m_network);
 
@@ -674,7 +772,7 @@ namespace stormphrax::eval {
                 }
 
                 if (m_top->ctx.updates.requiresThreatRefresh(c)) {
-                    refreshThreatAccumulator(*m_network, *m_top, c, pos);
+                    refreshThreatAccumulator(*m_network, *m_top, c, pos, m_threatRefreshTable);
                     continue;
                 }
 
@@ -684,7 +782,7 @@ namespace stormphrax::eval {
                 assert(curr != &m_accumulatorStack[0] || !curr->ctx.updates.requiresThreatRefresh(c));
 
                 if (curr->ctx.updates.requiresThreatRefresh(c)) {
-                    refreshThreatAccumulator(*m_network, *m_top, c, pos);
+                    refreshThreatAccumulator(*m_network, *m_top, c, pos, m_threatRefreshTable);
                 } else {
                     do {
                         const auto& prev = *curr++;
@@ -22,6 +22,7 @@
 
 #include <vector>
 
+#include "../util/multi_array.h"
 #include "nnue.h"
 
 namespace stormphrax::eval {
@@ -82,6 +83,18 @@ namespace stormphrax::eval {
         }
     };
 
+    // Threat accumulator for one perspective and mirror state, along with the sorted
+    // threat features it was built from. A refresh only applies the difference
+    // between those and the features of the new position
+    struct ThreatRefreshTableEntry {
+        util::simd::Array<i16, kL1Size> accumulator{};
+        nnue::features::threats::ThreatFeatureList features{};
+        bool valid{};
+    };
+
+    // [perspective][mirrored]
+    using ThreatRefreshTable = util::MultiArray<ThreatRefreshTableEntry, 2, 2>;
+
     class NnueState {
     public:
         NnueState() {
@@ -93,6 +106,19 @@ namespace stormphrax::eval {
             m_network = network;
         }
 
+        // Number of refresh table slots per perspective, 0 for one per king bucket and mirror
+        // state. Takes effect at the next reset(), which clears the table if this has changed
+        inline void setRefreshTableSize(u32 size) {
+            if (size != m_refreshTableSize) {
+                m_refreshTableSize = size;
+                m_refreshTableNetwork = nullptr;
+            }
+        }
+
+        [[nodiscard]] inline RefreshTableStats refreshTableStats() const {
+            return m_refreshTable.stats();
+        }
+
         void reset(const Position& pos);
 
         [[nodiscard]] BoardObserver push();
@@ -104,15 +130,28 @@ namespace stormphrax::eval {
 
         [[nodiscard]] static i32 evaluateOnce(const Position& pos, Color stm);
 
+        void ensureUpToDate(const Position& pos);
+
+        // Unconditionally refresh the current accumulator, for evalbench
+        void refreshPsq(const Position& pos, Color c);
+        void refreshThreats(const Position& pos, Color c);
+
+        [[nodiscard]] inline const UpdatableAccumulator& current() const {
+            return *m_top;
+        }
+
     private:
         std::vector<UpdatableAccumulator> m_accumulatorStack{};
         UpdatableAccumulator* m_top{};
 
         RefreshTable m_refreshTable{};
+        u32 m_refreshTableSize{};
+        // network the refresh table was last filled from
+        const Network* m_refreshTableNetwork{};
 
-        const Network* m_network{};
+        ThreatRefreshTable m_threatRefreshTable{};
 
-        void ensureUpToDate(const Position& pos);
+        const Network* m_network{};
     };
 
     inline void BoardObserver::prepareKingMove(Color c, Square src, Square dst) {
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <cstring>
 #include <span>
@@ -31,6 +32,7 @@
 #include "move.h"
 #include "tunable.h"
 #include "util/multi_array.h"
+#include "util/simd.h"
 
 namespace stormphrax {
     using HistoryScore = i16;
@@ -64,22 +66,47 @@ namespace stormphrax {
         return static_cast<HistoryScore>(std::clamp(depth * depthScale - offset, 0, max));
     }
 
+    // With SP_RELATIVE_CONTHIST, continuation history is indexed relative to the side that made the
+    // move a subtable is selected by, so both sides share one set of tables and the footprint halves
     class ContinuationSubtable {
     public:
-        //TODO take two args when c++23 is usable
-        inline HistoryScore operator[](std::pair<Piece, Move> move) const {
-            const auto [piece, mv] = move;
-            return m_data[piece.idx()][mv.toSq().idx()];
+        // offset is the number of plies between the move that selected this subtable and the current one
+        [[nodiscard]] inline HistoryScore get(Piece moving, Move move, i32 offset) const {
+            return m_data[pieceIdx(moving, offset)][squareIdx(moving, move.toSq(), offset)];
         }
 
-        inline HistoryEntry& operator[](std::pair<Piece, Move> move) {
-            const auto [piece, mv] = move;
-            return m_data[piece.idx()][mv.toSq().idx()];
+        [[nodiscard]] inline HistoryEntry& entry(Piece moving, Move move, i32 offset) {
+            return m_data[pieceIdx(moving, offset)][squareIdx(moving, move.toSq(), offset)];
         }
 
     private:
-        // [piece type][to]
+#ifdef SP_RELATIVE_CONTHIST
+        // [piece type][same side as previous mover][to, relative to previous mover]
+        util::MultiArray<HistoryEntry, PieceTypes::kCount * 2, Squares::kCount> m_data{};
+
+        [[nodiscard]] static inline usize pieceIdx(Piece moving, i32 offset) {
+            return moving.type().idx() * 2 + (offset & 1);
+        }
+
+        [[nodiscard]] static inline usize squareIdx(Piece moving, Square to, i32 offset) {
+            // sides alternate every ply, including null moves
+            const auto prevColor = (offset & 1) ? moving.color().flip() : moving.color();
+            return to.relative(prevColor).idx();
+        }
+#else
+        // [piece][to]
         util::MultiArray<HistoryEntry, Pieces::kCount, Squares::kCount> m_data{};
+
+        [[nodiscard]] static inline usize pieceIdx(Piece moving, i32 offset) {
+            SP_UNUSED(offset);
+            return moving.idx();
+        }
+
+        [[nodiscard]] static inline usize squareIdx(Piece moving, Square to, i32 offset) {
+            SP_UNUSED(moving, offset);
+            return to.idx();
+        }
+#endif
     };
 
     [[nodiscard]] inline HistoryScore getConthist(
@@ -90,7 +117,7 @@ namespace stormphrax {
         i32 offset
     ) {
         if (offset <= ply) {
-            return (*continuations[ply - offset])[{moving, move}];
+            return continuations[ply - offset]->get(moving, move, offset);
         }
 
         return 0;
@@ -108,37 +135,18 @@ namespace stormphrax {
         inline void age() {
             using namespace tunable;
 
-            for (i32 stm = 0; stm < Colors::kCount; ++stm) {
-                for (i32 from = 0; from < Squares::kCount; ++from) {
-                    for (i32 to = 0; to < Squares::kCount; ++to) {
-                        for (i32 srcThreat = 0; srcThreat < 2; ++srcThreat) {
-                            for (i32 dstThreat = 0; dstThreat < 2; ++dstThreat) {
-                                auto& v = m_butterfly[stm][from][to][srcThreat][dstThreat];
-                                v = v * butterflyAgeingWeight() / 1024;
-                            }
-                        }
-                    }
-                }
-            }
-
-            for (i32 piece = 0; piece < Pieces::kCount; ++piece) {
-                for (i32 to = 0; to < Squares::kCount; ++to) {
-                    for (i32 srcThreat = 0; srcThreat < 2; ++srcThreat) {
-                        for (i32 dstThreat = 0; dstThreat < 2; ++dstThreat) {
-                            auto& v = m_pieceTo[piece][to][srcThreat][dstThreat];
-                            v = v * pieceToAgeingWeight() / 1024;
-                        }
-                    }
-                }
-            }
+            ageEntries(m_butterfly.data(), sizeof(m_butterfly) / sizeof(HistoryEntry), butterflyAgeingWeight());
+            ageEntries(m_pieceTo.data(), sizeof(m_pieceTo) / sizeof(HistoryEntry), pieceToAgeingWeight());
         }
 
         [[nodiscard]] inline const ContinuationSubtable& contTable(Piece moving, Square to) const {
-            return m_continuation[moving.idx()][to.idx()];
+            const auto [pieceIdx, toIdx] = contTableIdx(moving, to);
+            return m_continuation[pieceIdx][toIdx];
         }
 
         [[nodiscard]] inline ContinuationSubtable& contTable(Piece moving, Square to) {
-            return m_continuation[moving.idx()][to.idx()];
+            const auto [pieceIdx, toIdx] = contTableIdx(moving, to);
+            return m_continuation[pieceIdx][toIdx];
         }
 
         inline void updateMainHistory(Bitboard threats, Piece moving, Move move, HistoryScore bonus) {
@@ -206,16 +214,61 @@ namespace stormphrax {
 
     private:
         // [stm][from][to][from attacked][to attacked]
-        util::MultiArray<HistoryEntry, Colors::kCount, Squares::kCount, Squares::kCount, 2, 2> m_butterfly{};
+        SP_SIMD_ALIGNAS util::MultiArray<HistoryEntry, Colors::kCount, Squares::kCount, Squares::kCount, 2, 2>
+            m_butterfly{};
         // [piece][to]
-        util::MultiArray<HistoryEntry, Pieces::kCount, Squares::kCount, 2, 2> m_pieceTo{};
-        // [prev piece][to][curr piece type][to]
+        SP_SIMD_ALIGNAS util::MultiArray<HistoryEntry, Pieces::kCount, Squares::kCount, 2, 2> m_pieceTo{};
+#ifdef SP_RELATIVE_CONTHIST
+        // [prev piece type][to, relative to prev mover]
+        util::MultiArray<ContinuationSubtable, PieceTypes::kCount, Squares::kCount> m_continuation{};
+#else
+        // [prev piece][to][curr piece][to]
         util::MultiArray<ContinuationSubtable, Pieces::kCount, Squares::kCount> m_continuation{};
+#endif
 
         // [from][to][captured][defended]
         // additional slot for non-capture queen promos
         util::MultiArray<HistoryEntry, Squares::kCount, Squares::kCount, Pieces::kCount + 1, 2> m_noisy{};
 
+        // v = v * weight / 1024 for every entry, rounding towards zero like the scalar expression.
+        // Done as an unsigned multiply-high of the magnitude with weight * 64, then the sign is reapplied
+        static inline void ageEntries(void* entries, usize count, i32 weight) {
+            namespace simd = util::simd;
+
+            static_assert(sizeof(HistoryEntry) == sizeof(i16));
+
+            assert(weight >= 0 && weight <= 1024);
+            assert(count % simd::kChunkSize<i16> == 0);
+
+            // weight * 64 would not fit in 16 bits
+            if (weight == 1024) {
+                return;
+            }
+
+            auto* values = static_cast<i16*>(entries);
+
+            const auto multiplier = simd::set1<i16>(static_cast<i16>(static_cast<u16>(weight * 64)));
+            const auto one = simd::set1<i16>(1);
+
+            for (usize i = 0; i < count; i += simd::kChunkSize<i16>) {
+                const auto v = simd::load<i16>(&values[i]);
+
+                const auto magnitude = simd::mulHiUnsigned<i16>(simd::abs<i16>(v), multiplier);
+                // -1 for negative entries, 1 otherwise
+                const auto sign = simd::add<i16>(simd::shiftLeft<i16>(simd::shiftRight<i16>(v, 15), 1), one);
+
+                simd::store<i16>(&values[i], simd::mulLo<i16>(magnitude, sign));
+            }
+        }
+
+        [[nodiscard]] static inline std::pair<usize, usize> contTableIdx(Piece moving, Square to) {
+#ifdef SP_RELATIVE_CONTHIST
+            return {moving.type().idx(), to.relative(moving.color()).idx()};
+#else
+            return {moving.idx(), to.idx()};
+#endif
+        }
+
         static inline void updateConthist(
             std::span<ContinuationSubtable*> continuations,
             i32 ply,
@@ -226,7 +279,8 @@ namespace stormphrax {
             i32 offset
         ) {
             if (offset <= ply) {
-                (*continuations[ply - offset])[{moving, move}].updateWithBase(bonus, base, tunable::maxConthist());
+                auto& entry = continuations[ply - offset]->entry(moving, move, offset);
+                entry.updateWithBase(bonus, base, tunable::maxConthist());
             }
         }
 
@@ -0,0 +1,168 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "iteration_log.h"
+
+#include <iterator>
+
+namespace stormphrax::search {
+    bool IterationLog::open(std::string_view path) {
+        close();
+
+        m_file.open(std::string{path}, std::ios::out | std::ios::app);
+
+        if (!m_file) {
+            eprintln("Failed to open iteration log {}", path);
+            return false;
+        }
+
+        return true;
+    }
+
+    void IterationLog::close() {
+        if (m_file.is_open()) {
+            m_file.close();
+        }
+
+        m_windows.clear();
+    }
+
+    void IterationLog::writeIteration(
+        const ThreadData& thread,
+        i32 depth,
+        usize nodes,
+        f64 time,
+        const limit::SearchLimiter& limiter,
+        bool stopping
+    ) {
+        if (!isOpen()) {
+            return;
+        }
+
+        const auto& pvMove = thread.pvMove();
+
+        u32 failHighs = 0;
+        u32 failLows = 0;
+
+        for (const auto& window : m_windows) {
+            failHighs += window.score >= window.beta;
+            failLows += window.score <= window.alpha;
+        }
+
+        auto out = std::back_inserter(m_buffer);
+
+        fmt::format_to(
+            out,
+            R"({{"type":"iteration","depth":{},"seldepth":{},"time":{:.6f},"nodes":{},"score":{},"bestmove":"{}",)",
+            depth,
+            pvMove.seldepth,
+            time,
+            nodes,
+            pvMove.score,
+            pvMove.move()
+        );
+
+        fmt::format_to(out, R"("failHighs":{},"failLows":{},"windows":[)", failHighs, failLows);
+
+        for (usize i = 0; i < m_windows.size(); ++i) {
+            const auto& window = m_windows[i];
+            fmt::format_to(
+                out,
+                R"({}{{"pv":{},"alpha":{},"beta":{},"score":{}}})",
+                i == 0 ? "" : ",",
+                window.pvIdx,
+                window.alpha,
+                window.beta,
+                window.score
+            );
+        }
+
+        fmt::format_to(out, R"(],"rootMoves":[)");
+
+        bool first = true;
+
+        for (const auto& rootMove : thread.rootMoves) {
+            if (rootMove.nodes == 0) {
+                continue;
+            }
+
+            fmt::format_to(
+                out,
+                R"({}{{"move":"{}","nodeFraction":{:.6f}}})",
+                first ? "" : ",",
+                rootMove.move(),
+                nodes == 0 ? 0.0 : static_cast<f64>(rootMove.nodes) / static_cast<f64>(nodes)
+            );
+
+            first = false;
+        }
+
+        fmt::format_to(out, R"(],"tm":)");
+
+        if (const auto* timeManager = limiter.timeManager()) {
+            const auto& factors = timeManager->scaleFactors();
+            fmt::format_to(
+                out,
+                R"({{"optTime":{:.6f},"maxTime":{:.6f},"scale":{:.6f},"nodeFactor":{:.6f},)"
+                R"("stabilityFactor":{:.6f},"scoreTrendFactor":{:.6f}}})",
+                timeManager->optTime(),
+                timeManager->maxTime(),
+                timeManager->scale(),
+                factors.nodes,
+                factors.stability,
+                factors.scoreTrend
+            );
+        } else {
+            fmt::format_to(out, "null");
+        }
+
+        fmt::format_to(out, R"(,"stopping":{}}})", stopping);
+
+        m_windows.clear();
+
+        flush();
+    }
+
+    void IterationLog::writeEnd(const ThreadData& thread, f64 time) {
+        if (!isOpen()) {
+            return;
+        }
+
+        fmt::format_to(
+            std::back_inserter(m_buffer),
+            R"({{"type":"end","time":{:.6f},"nodes":{},"depthCompleted":{},"bestmove":"{}"}})",
+            time,
+            thread.search.loadNodes(),
+            thread.depthCompleted,
+            thread.pvMove().move()
+        );
+
+        m_windows.clear();
+
+        flush();
+    }
+
+    void IterationLog::flush() {
+        m_buffer.push_back('\n');
+
+        m_file << m_buffer;
+        m_file.flush();
+
+        m_buffer.clear();
+    }
+} // namespace stormphrax::search
@@ -0,0 +1,80 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core.h"
+#include "limit.h"
+#include "thread.h"
+
+namespace stormphrax::search {
+    // Writes one JSON object per line for each completed iteration of the main thread,
+    // covering its aspiration windows, root move node distribution and time management,
+    // plus one when the search ends. Only used from the main search thread
+    class IterationLog {
+    public:
+        // Returns false if the file could not be opened, in which case logging is disabled
+        bool open(std::string_view path);
+        void close();
+
+        [[nodiscard]] inline bool isOpen() const {
+            return m_file.is_open();
+        }
+
+        inline void recordWindow(u32 pvIdx, Score alpha, Score beta, Score score) {
+            if (isOpen()) {
+                m_windows.push_back({pvIdx, alpha, beta, score});
+            }
+        }
+
+        void writeIteration(
+            const ThreadData& thread,
+            i32 depth,
+            usize nodes,
+            f64 time,
+            const limit::SearchLimiter& limiter,
+            bool stopping
+        );
+
+        void writeEnd(const ThreadData& thread, f64 time);
+
+    private:
+        struct Window {
+            u32 pvIdx;
+            Score alpha;
+            Score beta;
+            Score score;
+        };
+
+        std::ofstream m_file{};
+
+        // windows searched since the last completed iteration
+        std::vector<Window> m_windows{};
+
+        std::string m_buffer{};
+
+        void flush();
+    };
+} // namespace stormphrax::search
@@ -19,6 +19,7 @@
 #include "limit.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "opts.h"
 #include "tunable.h"
@@ -26,7 +27,15 @@
 
 namespace stormphrax::limit {
     namespace {
-        constexpr usize kTimeCheckInterval = 1024;
+        // Target wall-clock time between hard limit checks. Also capped
+        // to half the time left until the limit, so short searches stop on time
+        constexpr f64 kTimeCheckPeriod = 0.001;
+
+        // Used until the first check has measured the thread's speed
+        constexpr usize kInitialTimeCheckInterval = 16;
+
+        constexpr usize kMinTimeCheckInterval = 1;
+        constexpr usize kMaxTimeCheckInterval = 65536;
     } // namespace
 
     using namespace stormphrax::tunable;
@@ -54,6 +63,8 @@ namespace stormphrax::limit {
             m_prevBestMove = bestMove;
         }
 
+        m_scaleFactors = {};
+
         // try to resolve >tb scores that aren't full mates yet
         if (isMating(pvMove.score) && score >= kScoreMate - kMaxDepth) {
             m_scale = 0.15;
@@ -70,14 +81,12 @@ namespace stormphrax::limit {
             return;
         }
 
-        auto scale = 1.0;
-
         const auto bestMoveNodeFraction = static_cast<f64>(pvMove.nodes) / static_cast<f64>(totalNodes);
-        scale *= std::max(nodeTmBase() - bestMoveNodeFraction * nodeTmScale(), nodeTmScaleMin());
+        m_scaleFactors.nodes = std::max(nodeTmBase() - bestMoveNodeFraction * nodeTmScale(), nodeTmScaleMin());
 
         if (depth >= 6) {
             const auto stability = static_cast<f64>(m_stability);
-            scale *= std::min(
+            m_scaleFactors.stability = std::min(
                 bmStabilityTmMax(),
                 bmStabilityTmMin()
                     + bmStabilityTmScale() * std::pow(stability + bmStabilityTmOffset(), bmStabilityTmPower())
@@ -91,13 +100,14 @@ namespace stormphrax::limit {
             const auto invScale = scoreChange * scoreTrendTmScale() / (std::abs(scoreChange) + scoreTrendTmStretch())
                                 * (scoreChange > 0 ? scoreTrendTmPositiveScale() : scoreTrendTmNegativeScale());
 
-            scale *= std::clamp(1.0 - invScale, scoreTrendTmMin(), scoreTrendTmMax());
+            m_scaleFactors.scoreTrend = std::clamp(1.0 - invScale, scoreTrendTmMin(), scoreTrendTmMax());
 
             m_avgScore = util::ilerp<8>(avgScore, score, 1);
         } else {
             m_avgScore = score;
         }
 
+        const auto scale = m_scaleFactors.nodes * m_scaleFactors.stability * m_scaleFactors.scoreTrend;
         m_scale = std::max(scale, timeScaleMin());
     }
 
@@ -105,10 +115,6 @@ namespace stormphrax::limit {
         return time >= m_optTime * m_scale;
     }
 
-    bool TimeManager::stopHard(f64 time) const {
-        return time >= m_maxTime;
-    }
-
     void TimeManager::stopEarly() {
         // Clamp max search time to 500ms with one legal move or in TB draws
         // Worth no elo, exists for TCEC viewer experience
@@ -182,21 +188,13 @@ namespace stormphrax::limit {
         return false;
     }
 
-    bool SearchLimiter::stopHard(usize nodes) const {
+    bool SearchLimiter::stopHard(usize nodes) {
         if (m_hardNodes && nodes >= *m_hardNodes) {
             return true;
         }
 
-        if (nodes > 0 && nodes % kTimeCheckInterval == 0 && (m_moveTime || m_timeManager)) {
-            const auto time = m_startTime.elapsed();
-
-            if (m_moveTime && time >= *m_moveTime) {
-                return true;
-            }
-
-            if (m_timeManager && m_timeManager->stopHard(time)) {
-                return true;
-            }
+        if (nodes >= m_nextTimeCheck && (m_moveTime || m_timeManager)) {
+            return checkHardTime(nodes);
         }
 
         return false;
@@ -207,4 +205,49 @@ namespace stormphrax::limit {
             m_timeManager->stopEarly();
         }
     }
+
+    bool SearchLimiter::checkHardTime(usize nodes) {
+        const auto time = m_startTime.elapsed();
+
+        ++m_timeCheckStats.checks;
+
+        auto limit = std::numeric_limits<f64>::max();
+
+        if (m_moveTime) {
+            limit = *m_moveTime;
+        }
+
+        if (m_timeManager) {
+            limit = std::min(limit, m_timeManager->maxTime());
+        }
+
+        if (time >= limit) {
+            m_timeCheckStats.nodes = nodes;
+            m_timeCheckStats.overshoot = time - limit;
+            return true;
+        }
+
+        if (m_lastCheckNodes > 0 && time > m_lastCheckTime) {
+            const auto nps = static_cast<f64>(nodes - m_lastCheckNodes) / (time - m_lastCheckTime);
+            m_nps = m_nps == 0.0 ? nps : (m_nps * 3.0 + nps) / 4.0;
+        }
+
+        m_lastCheckNodes = nodes;
+        m_lastCheckTime = time;
+
+        auto interval = kInitialTimeCheckInterval;
+
+        if (m_nps > 0.0) {
+            const auto period = std::min(kTimeCheckPeriod, (limit - time) / 2.0);
+            interval = std::clamp(
+                static_cast<usize>(m_nps * period),
+                kMinTimeCheckInterval,
+                kMaxTimeCheckInterval
+            );
+        }
+
+        m_nextTimeCheck = nodes + interval;
+
+        return false;
+    }
 } // namespace stormphrax::limit
@@ -33,6 +33,13 @@ namespace stormphrax::limit {
         std::optional<i32> movesToGo{};
     };
 
+    // The individual factors making up the time manager's scale, 1 if not applied
+    struct TimeScaleFactors {
+        f64 nodes{1.0};
+        f64 stability{1.0};
+        f64 scoreTrend{1.0};
+    };
+
     class TimeManager {
     public:
         explicit TimeManager(const TimeLimits& limits);
@@ -40,15 +47,32 @@ namespace stormphrax::limit {
         void update(i32 depth, usize totalNodes, const search::RootMove& pvMove);
 
         [[nodiscard]] bool stopSoft(f64 time) const;
-        [[nodiscard]] bool stopHard(f64 time) const;
 
         void stopEarly();
 
+        [[nodiscard]] inline f64 optTime() const {
+            return m_optTime;
+        }
+
+        [[nodiscard]] inline f64 maxTime() const {
+            return m_maxTime;
+        }
+
+        // Applied to the optimum time
+        [[nodiscard]] inline f64 scale() const {
+            return m_scale;
+        }
+
+        [[nodiscard]] inline const TimeScaleFactors& scaleFactors() const {
+            return m_scaleFactors;
+        }
+
     private:
         f64 m_optTime;
         f64 m_maxTime;
 
         f64 m_scale{1.0};
+        TimeScaleFactors m_scaleFactors{};
 
         Move m_prevBestMove{};
         u32 m_stability{};
@@ -56,6 +80,14 @@ namespace stormphrax::limit {
         std::optional<Score> m_avgScore{};
     };
 
+    struct TimeCheckStats {
+        usize checks{};
+        // Nodes searched by the checking thread when the hard time limit was hit
+        usize nodes{};
+        // Time between the hard time limit and its detection, if it was hit
+        std::optional<f64> overshoot{};
+    };
+
     class SearchLimiter {
     public:
         explicit SearchLimiter(util::Instant startTime);
@@ -70,18 +102,39 @@ namespace stormphrax::limit {
         void update(i32 depth, usize totalNodes, const search::RootMove& pvMove);
 
         [[nodiscard]] bool stopSoft(usize nodes) const;
-        [[nodiscard]] bool stopHard(usize nodes) const;
+        // Must only be called from one thread, with that thread's node count
+        [[nodiscard]] bool stopHard(usize nodes);
 
         void stopEarly();
 
+        [[nodiscard]] inline const TimeCheckStats& timeCheckStats() const {
+            return m_timeCheckStats;
+        }
+
+        // Null unless searching with tournament time
+        [[nodiscard]] inline const TimeManager* timeManager() const {
+            return m_timeManager ? &*m_timeManager : nullptr;
+        }
+
     private:
         util::Instant m_startTime;
 
+        // The clock is only read every so many nodes, adapted to the checking
+        // thread's measured speed so that checks happen at a roughly fixed period
+        usize m_nextTimeCheck{};
+        usize m_lastCheckNodes{};
+        f64 m_lastCheckTime{};
+        f64 m_nps{};
+
+        TimeCheckStats m_timeCheckStats{};
+
         std::optional<usize> m_hardNodes;
         std::optional<usize> m_softNodes;
 
         std::optional<f64> m_moveTime;
 
         std::optional<TimeManager> m_timeManager;
+
+        [[nodiscard]] bool checkHardTime(usize nodes);
     };
 } // namespace stormphrax::limit
@@ -26,6 +26,7 @@
 #include "eval/nnue.h"
 #include "tunable.h"
 #include "uci/uci.h"
+#include "util/cpu.h"
 #include "util/numa/numa.h"
 #include "util/parse.h"
 
@@ -104,7 +105,22 @@ namespace {
     }
 } // namespace
 
+#ifdef SP_DISPATCH_ENTRY
+// Multi-arch builds link one copy of the engine per variant, with every symbol but
+// this one localised. The dispatcher in dispatch.cpp calls the best supported variant
+extern "C" i32 SP_DISPATCH_ENTRY(i32 argc, const char* argv[]) {
+#else
 i32 main(i32 argc, const char* argv[]) {
+#endif
+    if (const auto missing = util::cpu::missingBuildFeatures(); !missing.empty()) {
+        eprint("This build of Stormphrax requires CPU features not supported by this machine:");
+        for (const auto feature : missing) {
+            eprint(" {}", feature);
+        }
+        eprintln();
+        return 1;
+    }
+
     if (!numa::init()) {
         eprintln("Failed to initialize NUMA support");
         return 1;
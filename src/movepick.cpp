@@ -18,10 +18,15 @@
 
 #include "movepick.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <limits>
+#include <span>
 
 #include "see.h"
 #include "tunable.h"
+#include "util/cemath.h"
 
 namespace stormphrax {
     Move MoveGenerator::next() {
@@ -229,7 +234,11 @@ namespace stormphrax {
             if (move.type() == MoveType::kPromotion) {
                 score += see::value(PieceTypes::kQueen) - see::value(PieceTypes::kPawn);
             }
+
+            m_data.scores[i] = score;
         }
+
+        padScores();
     }
 
     void MoveGenerator::scoreQuiets() {
@@ -255,31 +264,125 @@ namespace stormphrax {
 
             score /= 1024;
 
-            score +=
-                directCheckBonus() * (m_pos.givesDirectCheck(move) && see::see(m_pos, move, directCheckSeeThreshold()));
+            // Direct checks optimistically get the bonus for passing SEE. This is an upper bound on
+            // their real score, so nothing can be selected ahead of a check that should have beaten
+            // it, and the checks are only SEEd if one of them would actually be selected
+            if (m_pos.givesDirectCheck(move)) {
+                score += directCheckBonus();
+
+                m_pendingChecks[i] = true;
+                ++m_pendingCheckCount;
+            }
+
+            m_data.scores[i] = score;
+        }
+
+        padScores();
+    }
+
+    void MoveGenerator::resolveChecks() {
+        using namespace tunable;
+
+        assert(m_pendingCheckCount > 0);
+
+        // all pending checks are SEEd in one batch
+        u32 checkCount{};
+        std::array<u32, kDefaultMoveListCapacity> checkIndices;
+        std::array<Move, kDefaultMoveListCapacity> checks;
+
+        for (u32 i = m_idx; i < m_end; ++i) {
+            if (m_pendingChecks[i]) {
+                checkIndices[checkCount] = i;
+                checks[checkCount] = m_data.moves[i].move;
+                ++checkCount;
+            }
+        }
+
+        assert(checkCount == m_pendingCheckCount);
+
+        std::array<Score, kDefaultMoveListCapacity> thresholds;
+        std::array<bool, kDefaultMoveListCapacity> passed;
+
+        std::fill_n(thresholds.begin(), checkCount, directCheckSeeThreshold());
+
+        see::see(m_pos, std::span{checks}.first(checkCount), std::span{thresholds}.first(checkCount), passed);
+
+        for (u32 check = 0; check < checkCount; ++check) {
+            if (!passed[check]) {
+                const auto i = checkIndices[check];
+
+                m_data.moves[i].score -= directCheckBonus();
+                m_data.scores[i] = m_data.moves[i].score;
+            }
+        }
+
+        m_pendingChecks.reset();
+        m_pendingCheckCount = 0;
+    }
+
+    void MoveGenerator::padScores() {
+        static constexpr usize kChunk = util::simd::kChunkSize<i32>;
+        static_assert(kDefaultMoveListCapacity % kChunk == 0);
+
+        const auto paddedEnd = util::ceilDiv<usize>(m_end, kChunk) * kChunk;
+
+        for (auto i = m_end; i < paddedEnd; ++i) {
+            m_data.scores[i] = MovegenData::kSelectedScore;
         }
     }
 
     u32 MoveGenerator::findNext() {
-        const auto toU64 = [](i32 s) {
-            i64 widened = s;
-            widened -= std::numeric_limits<i32>::min();
-            return static_cast<u64>(widened) << 32;
-        };
+        namespace simd = util::simd;
+
+        static constexpr usize kChunk = simd::kChunkSize<i32>;
+
+        assert(m_idx < m_end);
+
+        auto& scores = m_data.scores;
+
+        // everything below m_idx in the first chunk has already been selected
+        const auto begin = m_idx / kChunk * kChunk;
 
-        auto best = toU64(m_data.moves[m_idx].score) | (256 - m_idx);
+        auto best = simd::set1<i32>(MovegenData::kSelectedScore);
 
-        for (auto i = m_idx + 1; i < m_end; ++i) {
-            const auto curr = toU64(m_data.moves[i].score) | (256 - i);
-            best = std::max(best, curr);
+        for (auto i = begin; i < m_end; i += kChunk) {
+            best = simd::max<i32>(best, simd::load<i32>(&scores[i]));
         }
 
-        const auto bestIdx = 256 - (best & 0xFFFFFFFF);
+        const auto bestScore = simd::set1<i32>(simd::hmax<i32>(best));
+
+        // lowest index with the best score, matching a stable selection sort
+        auto bestIdx = m_end;
+
+        for (auto i = begin; i < m_end; i += kChunk) {
+            if (const auto mask = simd::equalMask<i32>(simd::load<i32>(&scores[i]), bestScore)) {
+                bestIdx = i + std::countr_zero(mask);
+                break;
+            }
+        }
+
+        assert(bestIdx >= m_idx && bestIdx < m_end);
+        assert(scores[bestIdx] == m_data.moves[bestIdx].score);
+
+        if (m_pendingCheckCount > 0) {
+            // the best move's score is only an upper bound, so settle every check's score and
+            // select again. Selection order is exactly the same as if they had been SEEd up front
+            if (m_pendingChecks[bestIdx]) {
+                resolveChecks();
+                return findNext();
+            }
+
+            m_pendingChecks[bestIdx] = m_pendingChecks[m_idx];
+            m_pendingChecks[m_idx] = false;
+        }
 
         if (bestIdx != m_idx) {
             std::swap(m_data.moves[m_idx], m_data.moves[bestIdx]);
+            scores[bestIdx] = scores[m_idx];
         }
 
+        scores[m_idx] = MovegenData::kSelectedScore;
+
         return m_idx++;
     }
 } // namespace stormphrax
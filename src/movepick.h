@@ -20,12 +20,21 @@
 
 #include "types.h"
 
+#include <bitset>
+#include <limits>
+
 #include "history.h"
 #include "movegen.h"
+#include "util/simd.h"
 
 namespace stormphrax {
     struct MovegenData {
         ScoredMoveList moves;
+        // Copy of the scores in moves, for vectorised selection. Entries that have already
+        // been selected, and padding up to the next full vector, are kSelectedScore
+        util::simd::Array<i32, kDefaultMoveListCapacity> scores;
+
+        static constexpr i32 kSelectedScore = std::numeric_limits<i32>::min();
     };
 
     enum class MovegenStage : i32 {
@@ -127,6 +136,10 @@ namespace stormphrax {
         void scoreNoisies();
         void scoreQuiets();
 
+        void resolveChecks();
+
+        void padScores();
+
         [[nodiscard]] u32 findNext();
 
         template <bool kSort = true>
@@ -165,5 +178,10 @@ namespace stormphrax {
         u32 m_end{};
 
         u32 m_badNoisyEnd{};
+
+        // Quiet direct checks are scored as if they pass SEE, and are only SEEd once one
+        // of them would be selected - see scoreQuiets. Indexed by position in the move list
+        std::bitset<kDefaultMoveListCapacity> m_pendingChecks{};
+        u32 m_pendingCheckCount{};
     };
 } // namespace stormphrax
@@ -40,6 +40,10 @@ namespace stormphrax {
         constexpr i32 kDefaultContempt = 0;
         constexpr auto kContemptRange = util::Range<i32>{-1000, 1000};
 
+        // 0 = one slot per king bucket and mirror state, larger values are clamped to that
+        constexpr i32 kDefaultRefreshTableSize = 0;
+        constexpr auto kRefreshTableSizeRange = util::Range<i32>{0, 64};
+
         struct GlobalOptions {
             i32 threads{kDefaultThreadCount};
 
@@ -66,6 +70,8 @@ namespace stormphrax {
             bool syzygyProbeRootOnly{false};
 
             i32 contempt{kDefaultContempt};
+
+            i32 refreshTableSize{kDefaultRefreshTableSize};
         };
 
         GlobalOptions& mutableOpts();
@@ -18,21 +18,83 @@
 
 #include "perft.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
 #include "movegen.h"
+#include "opts.h"
+#include "util/numa/numa.h"
 #include "util/timer.h"
 
 namespace stormphrax {
     using util::Instant;
 
     namespace {
-        usize doPerft(const Position& pos, i32 depth) {
+        // Lockless (key ^ data) shared hash of subtree counts, so torn entries
+        // written concurrently by two threads are detected as misses on probe
+        class PerftTable {
+        public:
+            explicit PerftTable(usize mib) :
+                    m_entries(std::max<usize>(mib * 1024 * 1024 / sizeof(Entry), 1)) {}
+
+            [[nodiscard]] inline std::optional<usize> probe(u64 key, i32 depth) const {
+                const auto& entry = m_entries[index(key)];
+
+                const auto data = entry.data.load(std::memory_order::relaxed);
+                const auto check = entry.key.load(std::memory_order::relaxed);
+
+                if ((check ^ data) != key || static_cast<i32>(data & 0xFF) != depth) {
+                    return {};
+                }
+
+                return static_cast<usize>(data >> 8);
+            }
+
+            inline void store(u64 key, i32 depth, usize count) {
+                auto& entry = m_entries[index(key)];
+
+                const auto data = (static_cast<u64>(count) << 8) | static_cast<u64>(depth);
+
+                entry.key.store(key ^ data, std::memory_order::relaxed);
+                entry.data.store(data, std::memory_order::relaxed);
+            }
+
+        private:
+            struct Entry {
+                std::atomic<u64> key{};
+                std::atomic<u64> data{};
+            };
+
+            [[nodiscard]] inline u64 index(u64 key) const {
+                return static_cast<u64>((static_cast<u128>(key) * static_cast<u128>(m_entries.size())) >> 64);
+            }
+
+            std::vector<Entry> m_entries;
+        };
+
+        usize doPerft(const Position& pos, i32 depth, PerftTable* table, usize& hashHits) {
             if (depth <= 0) {
                 return 1;
             }
 
+            if (table && depth > 1) {
+                if (const auto count = table->probe(pos.key(), depth)) {
+                    ++hashHits;
+                    return *count;
+                }
+            }
+
             ScoredMoveList moves{};
             generateAll(moves, pos);
 
+            // bulk counting
             if (depth == 1) {
                 return moves.size();
             }
@@ -41,37 +103,469 @@ namespace stormphrax {
 
             for (const auto [move, score] : moves) {
                 const auto newPos = pos.applyMove(move);
-                total += doPerft(newPos, depth - 1);
+                total += doPerft(newPos, depth - 1, table, hashHits);
+            }
+
+            if (table) {
+                table->store(pos.key(), depth, total);
+            }
+
+            return total;
+        }
+
+        struct PerftThreadStats {
+            usize nodes{};
+            usize hashHits{};
+            f64 time{};
+        };
+
+        struct PerftRun {
+            std::vector<usize> rootCounts{};
+            std::vector<PerftThreadStats> threads{};
+            f64 time{};
+
+            [[nodiscard]] inline usize total() const {
+                usize total{};
+
+                for (const auto count : rootCounts) {
+                    total += count;
+                }
+
+                return total;
+            }
+        };
+
+        [[nodiscard]] inline usize nps(usize nodes, f64 time) {
+            return static_cast<usize>(static_cast<f64>(nodes) / std::max(time, 0.000001));
+        }
+
+        // Work is split into positions 2 plies from the root (1 ply for depth 2), as there are
+        // usually too few root moves to keep many threads busy. Threads take positions in order
+        PerftRun runPerft(
+            const Position& pos,
+            i32 depth,
+            const ScoredMoveList& rootMoves,
+            u32 threadCount,
+            PerftTable* table
+        ) {
+            assert(depth >= 1);
+
+            struct WorkItem {
+                u32 root;
+                Position pos;
+            };
+
+            PerftRun run{};
+            run.rootCounts.resize(rootMoves.size());
+
+            const auto start = Instant::now();
+
+            if (depth == 1) {
+                std::ranges::fill(run.rootCounts, 1);
+                run.threads.resize(1);
+                run.threads[0].nodes = rootMoves.size();
+                run.time = run.threads[0].time = start.elapsed();
+                return run;
+            }
+
+            std::vector<WorkItem> items{};
+
+            for (u32 rootIdx = 0; rootIdx < rootMoves.size(); ++rootIdx) {
+                const auto child = pos.applyMove(rootMoves[rootIdx].move);
+
+                if (depth == 2) {
+                    items.push_back({rootIdx, child});
+                    continue;
+                }
+
+                ScoredMoveList replies{};
+                generateAll(replies, child);
+
+                for (const auto [reply, score] : replies) {
+                    items.push_back({rootIdx, child.applyMove(reply)});
+                }
+            }
+
+            const auto itemDepth = depth == 2 ? 1 : depth - 2;
+
+            threadCount = std::max<u32>(threadCount, 1);
+
+            std::atomic<usize> next{0};
+
+            std::vector<std::vector<usize>> threadRootCounts(threadCount, std::vector<usize>(rootMoves.size()));
+            run.threads.resize(threadCount);
+
+            std::vector<std::thread> threads{};
+            threads.reserve(threadCount);
+
+            for (u32 threadId = 0; threadId < threadCount; ++threadId) {
+                threads.emplace_back([&, threadId] {
+                    // placed the same way as search and datagen threads
+                    numa::bindThread(threadId);
+
+                    const auto threadStart = Instant::now();
+
+                    auto& rootCounts = threadRootCounts[threadId];
+
+                    usize nodes{};
+                    usize hashHits{};
+
+                    while (true) {
+                        const auto itemIdx = next.fetch_add(1, std::memory_order::relaxed);
+
+                        if (itemIdx >= items.size()) {
+                            break;
+                        }
+
+                        const auto& item = items[itemIdx];
+                        const auto count = doPerft(item.pos, itemDepth, table, hashHits);
+
+                        rootCounts[item.root] += count;
+                        nodes += count;
+                    }
+
+                    run.threads[threadId] = {nodes, hashHits, threadStart.elapsed()};
+                });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            for (const auto& rootCounts : threadRootCounts) {
+                for (usize rootIdx = 0; rootIdx < rootCounts.size(); ++rootIdx) {
+                    run.rootCounts[rootIdx] += rootCounts[rootIdx];
+                }
+            }
+
+            run.time = start.elapsed();
+
+            return run;
+        }
+
+        [[nodiscard]] std::unique_ptr<PerftTable> createTable(usize hashMib) {
+            if (hashMib == 0) {
+                return nullptr;
+            }
+
+            return std::make_unique<PerftTable>(hashMib);
+        }
+
+        void printThreadStats(std::span<const PerftThreadStats> threads) {
+            for (usize threadId = 0; threadId < threads.size(); ++threadId) {
+                const auto& stats = threads[threadId];
+                println(
+                    "thread {}: {} nodes, {} nps, {} hash hits",
+                    threadId,
+                    stats.nodes,
+                    nps(stats.nodes, stats.time),
+                    stats.hashHits
+                );
+            }
+        }
+
+        struct PerftSuiteEntry {
+            std::string_view fen;
+            bool frc;
+            // known results for depths 1 through n
+            std::array<usize, 6> counts;
+        };
+
+        // Standard positions from the Chess Programming Wiki, FRC positions from
+        // Reinhard Scharnagl's Chess960 perft suite. The DFRC results are this
+        // move generator's own, as regression tests for asymmetric castling
+        constexpr auto kPerftSuite = std::array{
+            PerftSuiteEntry{
+                "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                false,
+                {20, 400, 8902, 197281, 4865609, 119060324}
+            },
+            PerftSuiteEntry{
+                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                false,
+                {48, 2039, 97862, 4085603, 193690690}
+            },
+            PerftSuiteEntry{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", false, {14, 191, 2812, 43238, 674624, 11030083}},
+            PerftSuiteEntry{
+                "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                false,
+                {6, 264, 9467, 422333, 15833292}
+            },
+            PerftSuiteEntry{
+                "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+                false,
+                {6, 264, 9467, 422333, 15833292}
+            },
+            PerftSuiteEntry{
+                "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                false,
+                {44, 1486, 62379, 2103487, 89941194}
+            },
+            PerftSuiteEntry{
+                "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+                false,
+                {46, 2079, 89890, 3894594, 164075551}
+            },
+            PerftSuiteEntry{
+                "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+                true,
+                {21, 528, 12189, 326672, 8146062, 227689589}
+            },
+            PerftSuiteEntry{
+                "2nnrbkr/p1qppppp/8/1ppb4/6PP/3PP3/PPP2P2/BQNNRBKR w HEhe - 1 9",
+                true,
+                {21, 807, 18002, 667366, 16253601, 590751109}
+            },
+            PerftSuiteEntry{
+                "b1q1rrkb/pppppppp/3nn3/8/P7/1PPP4/4PPPP/BQNNRKRB w GE - 1 9",
+                true,
+                {20, 479, 10471, 273318, 6417013, 177654692}
+            },
+            PerftSuiteEntry{
+                "qbbnnrkr/2pp2pp/p7/1p2pp2/8/P3PP2/1PPP1KPP/QBBNNR1R w hf - 0 9",
+                true,
+                {22, 593, 13440, 382958, 9183776, 274103539}
+            },
+            PerftSuiteEntry{
+                "nrbqkrnb/pppppppp/8/8/8/8/PPPPPPPP/NRQKNRBB w FBfb - 0 1",
+                true,
+                {19, 361, 7803, 166580, 4014164, 94944800}
+            },
+            PerftSuiteEntry{
+                "rkqnbbrn/pppppppp/8/8/8/8/PPPPPPPP/BNRBNKRQ w GCga - 0 1",
+                true,
+                {21, 399, 9215, 197920, 4967374, 118261317}
+            },
+            PerftSuiteEntry{
+                "nrk2r1b/ppp1pppp/3p4/8/4P3/8/PPPP1PPP/NB1R2KR w HDfb - 0 5",
+                true,
+                {22, 506, 11225, 263109, 5935558, 141913626}
+            },
+        };
+
+        // No bulk counting or hashing in either mode, so that every node pays for a move
+        usize copyMakePerft(const Position& pos, i32 depth) {
+            if (depth <= 0) {
+                return 1;
+            }
+
+            ScoredMoveList moves{};
+            generateAll(moves, pos);
+
+            usize total{};
+
+            for (const auto [move, score] : moves) {
+                const auto newPos = pos.applyMove(move);
+                total += copyMakePerft(newPos, depth - 1);
+            }
+
+            return total;
+        }
+
+        usize makeUnmakePerft(Position& pos, i32 depth, std::span<PositionUndo> undoStack) {
+            if (depth <= 0) {
+                return 1;
+            }
+
+            ScoredMoveList moves{};
+            generateAll(moves, pos);
+
+            auto& undo = undoStack[0];
+
+            usize total{};
+
+            for (const auto [move, score] : moves) {
+                pos.makeMove(move, undo);
+                total += makeUnmakePerft(pos, depth - 1, undoStack.subspan(1));
+                pos.unmakeMove(move, undo);
             }
 
             return total;
         }
     } // namespace
 
-    void perft(const Position& pos, i32 depth) {
-        println("{}", doPerft(pos, depth));
+    void perft(const Position& pos, i32 depth, u32 threads, usize hashMib) {
+        if (depth <= 0) {
+            println("1");
+            return;
+        }
+
+        ScoredMoveList moves{};
+        generateAll(moves, pos);
+
+        const auto table = createTable(hashMib);
+        const auto run = runPerft(pos, depth, moves, threads, table.get());
+
+        println("{}", run.total());
     }
 
-    void splitPerft(const Position& pos, i32 depth) {
-        const auto start = Instant::now();
+    void splitPerft(const Position& pos, i32 depth, u32 threads, usize hashMib) {
+        if (depth <= 0) {
+            println();
+            println("total 1");
+            return;
+        }
 
         ScoredMoveList moves{};
         generateAll(moves, pos);
 
-        usize total{};
-
-        for (const auto [move, score] : moves) {
-            const auto newPos = pos.applyMove(move);
-            const auto value = doPerft(newPos, depth - 1);
+        const auto table = createTable(hashMib);
+        const auto run = runPerft(pos, depth, moves, threads, table.get());
 
-            total += value;
-            println("{}\t{}", move, value);
+        for (u32 i = 0; i < moves.size(); ++i) {
+            println("{}\t{}", moves[i].move, run.rootCounts[i]);
         }
 
-        const auto nps = static_cast<usize>(static_cast<f64>(total) / start.elapsed());
+        const auto total = run.total();
 
         println();
         println("total {}", total);
-        println("{} nps", nps);
+        println("{} nps", nps(total, run.time));
+
+        if (run.threads.size() > 1 || hashMib > 0) {
+            println();
+            printThreadStats(run.threads);
+        }
+    }
+
+    bool perftSuite(i32 maxDepth, u32 threads, usize hashMib) {
+        const bool prevChess960 = g_opts.chess960;
+
+        // counts depend only on the position, so the table is shared across the whole suite
+        const auto table = createTable(hashMib);
+
+        usize totalNodes{};
+        f64 totalTime{};
+
+        std::vector<PerftThreadStats> threadTotals{};
+
+        u32 failed{};
+
+        for (const auto& entry : kPerftSuite) {
+            // castling rights in FRC FENs only parse, and FRC castling moves are only generated, in 960 mode
+            opts::mutableOpts().chess960 = entry.frc;
+
+            const auto pos = Position::fromFen(entry.fen);
+
+            if (!pos) {
+                eprintln("invalid suite fen {}", entry.fen);
+                ++failed;
+                continue;
+            }
+
+            ScoredMoveList moves{};
+            generateAll(moves, *pos);
+
+            for (i32 depth = 1; depth <= maxDepth && depth <= static_cast<i32>(entry.counts.size()); ++depth) {
+                const auto expected = entry.counts[depth - 1];
+
+                if (expected == 0) {
+                    break;
+                }
+
+                const auto run = runPerft(*pos, depth, moves, threads, table.get());
+                const auto total = run.total();
+
+                if (total != expected) {
+                    println("FAIL {} depth {}: {} (expected {})", entry.fen, depth, total, expected);
+                    ++failed;
+                    break;
+                }
+
+                totalNodes += total;
+                totalTime += run.time;
+
+                threadTotals.resize(std::max(threadTotals.size(), run.threads.size()));
+
+                for (usize threadId = 0; threadId < run.threads.size(); ++threadId) {
+                    threadTotals[threadId].nodes += run.threads[threadId].nodes;
+                    threadTotals[threadId].hashHits += run.threads[threadId].hashHits;
+                    threadTotals[threadId].time += run.threads[threadId].time;
+                }
+
+                if (depth == maxDepth || depth == static_cast<i32>(entry.counts.size())
+                    || entry.counts[depth] == 0)
+                {
+                    println("ok   {} depth {}: {}", entry.fen, depth, total);
+                }
+            }
+        }
+
+        opts::mutableOpts().chess960 = prevChess960;
+
+        println();
+        println("{} / {} positions passed", kPerftSuite.size() - failed, kPerftSuite.size());
+        println("{} nodes {} nps", totalNodes, nps(totalNodes, totalTime));
+        println();
+        printThreadStats(threadTotals);
+
+        return failed == 0;
+    }
+
+    bool makeUnmakeBench(i32 depth) {
+        const bool prevChess960 = g_opts.chess960;
+
+        std::vector<PositionUndo> undoStack(std::max(depth, 1));
+
+        usize copyNodes{};
+        usize makeNodes{};
+
+        f64 copyTime{};
+        f64 makeTime{};
+
+        u32 failed{};
+
+        for (const auto& entry : kPerftSuite) {
+            opts::mutableOpts().chess960 = entry.frc;
+
+            const auto pos = Position::fromFen(entry.fen);
+
+            if (!pos) {
+                eprintln("invalid suite fen {}", entry.fen);
+                ++failed;
+                continue;
+            }
+
+            // not every entry has results for all depths
+            auto entryDepth = std::min(depth, static_cast<i32>(entry.counts.size()));
+            while (entryDepth > 0 && entry.counts[entryDepth - 1] == 0) {
+                --entryDepth;
+            }
+
+            const auto expected = entryDepth > 0 ? entry.counts[entryDepth - 1] : 1;
+
+            const auto copyStart = Instant::now();
+            const auto copyCount = copyMakePerft(*pos, entryDepth);
+            copyTime += copyStart.elapsed();
+
+            auto makePos = *pos;
+
+            const auto makeStart = Instant::now();
+            const auto makeCount = makeUnmakePerft(makePos, entryDepth, undoStack);
+            makeTime += makeStart.elapsed();
+
+            if (copyCount != expected || makeCount != expected || makePos.key() != pos->key()) {
+                println(
+                    "FAIL {} depth {}: copy-make {}, make/unmake {} (expected {})",
+                    entry.fen,
+                    entryDepth,
+                    copyCount,
+                    makeCount,
+                    expected
+                );
+                ++failed;
+            }
+
+            copyNodes += copyCount;
+            makeNodes += makeCount;
+        }
+
+        opts::mutableOpts().chess960 = prevChess960;
+
+        println("{} / {} positions matched", kPerftSuite.size() - failed, kPerftSuite.size());
+        println("copy-make:   {} nodes {:.3f} sec {} nps", copyNodes, copyTime, nps(copyNodes, copyTime));
+        println("make/unmake: {} nodes {:.3f} sec {} nps", makeNodes, makeTime, nps(makeNodes, makeTime));
+
+        return failed == 0;
     }
 } // namespace stormphrax
@@ -23,6 +23,17 @@
 #include "position.h"
 
 namespace stormphrax {
-    void perft(const Position& pos, i32 depth);
-    void splitPerft(const Position& pos, i32 depth);
+    constexpr usize kDefaultPerftHashMib = 16;
+
+    // threads split the work at the root, and share a perft hash of hashMib MiB (0 to disable)
+    void perft(const Position& pos, i32 depth, u32 threads = 1, usize hashMib = 0);
+    void splitPerft(const Position& pos, i32 depth, u32 threads = 1, usize hashMib = 0);
+
+    // Checks the move generator against a built-in suite of known perft results, including
+    // FRC and DFRC positions, up to maxDepth. Returns false if any result is wrong
+    bool perftSuite(i32 maxDepth, u32 threads, usize hashMib);
+
+    // A/B comparison of copy-make (Position::applyMove) and make/unmake (Position::makeMove)
+    // over the perft suite at depth, without bulk counting. Returns false if the modes disagree
+    bool makeUnmakeBench(i32 depth);
 } // namespace stormphrax
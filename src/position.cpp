@@ -19,6 +19,7 @@
 #include "position.h"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstdlib>
 #include <iterator>
@@ -32,6 +33,7 @@
 #include "opts.h"
 #include "rays.h"
 #include "util/parse.h"
+#include "util/simd.h"
 #include "util/split.h"
 
 namespace stormphrax {
@@ -102,6 +104,93 @@ namespace stormphrax {
 
             return dst;
         }
+
+        // Calls f with each index in [first, last] that holds key, from last down to first,
+        // until f returns true. With kSameSide, only every second index back from last is
+        // considered, as positions with the other side to move cannot have the same key
+        template <bool kSameSide, typename F>
+        bool findKey(std::span<const u64> keys, u64 key, i32 first, i32 last, F&& f) {
+            namespace simd = util::simd;
+
+            constexpr auto kChunkSize = static_cast<i32>(simd::kChunkSize<u64>);
+            static_assert(kChunkSize % 2 == 0);
+
+            const auto scalar = [&] {
+                for (auto idx = last; idx >= first; idx -= kSameSide ? 2 : 1) {
+                    if (keys[idx] == key && f(idx)) {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+            // With fewer than 8 keys per vector (AVX2, NEON), the vector scan is no faster
+            if constexpr (kChunkSize < 8) {
+                return scalar();
+            }
+
+            // too short to be worth vectorising, or shorter than a single chunk
+            if (last - first + 1 < kChunkSize * 2 || static_cast<i32>(keys.size()) < kChunkSize) {
+                return scalar();
+            }
+
+            const auto target = simd::set1<u64>(key);
+
+            // lanes holding keys on the same side as last, for a chunk starting at start
+            const auto sideMask = [&](i32 start) -> u32 {
+                if constexpr (kSameSide) {
+                    return ((last - start) & 1) != 0 ? 0xAAAAAAAA : 0x55555555;
+                } else {
+                    return ~u32{0};
+                }
+            };
+
+            const auto scan = [&](i32 start, u32 matches) {
+                while (matches != 0) {
+                    const auto lane = std::bit_width(matches) - 1;
+                    if (f(start + static_cast<i32>(lane))) {
+                        return true;
+                    }
+
+                    matches &= ~(u32{1} << lane);
+                }
+
+                return false;
+            };
+
+            auto hi = last;
+
+            // Full chunks, stepping back an even number of keys at a time, so the
+            // same side's keys stay in the same lanes and matches are almost never found
+            const auto fullChunkMask = sideMask(last - kChunkSize + 1);
+
+            for (; hi - kChunkSize + 1 >= first; hi -= kChunkSize) {
+                const auto start = hi - kChunkSize + 1;
+                const auto matches =
+                    simd::equalMask<u64>(simd::loadUnaligned<u64>(&keys[start]), target) & fullChunkMask;
+
+                if (matches != 0 && scan(start, matches)) {
+                    return true;
+                }
+            }
+
+            if (hi < first) {
+                return false;
+            }
+
+            // The rest of the range is less than a chunk. Load a full chunk ending at hi if
+            // possible, or otherwise starting at the beginning of the history, and mask off
+            // anything outside the range
+            const auto start = std::max(hi - kChunkSize + 1, 0);
+
+            auto valid = sideMask(start);
+            valid &= (u32{2} << (hi - start)) - 1;
+            valid &= ~((u32{1} << (first - start)) - 1);
+
+            const auto matches = simd::equalMask<u64>(simd::loadUnaligned<u64>(&keys[start]), target) & valid;
+            return matches != 0 && scan(start, matches);
+        }
     } // namespace
 
     using NnueObserver = eval::BoardObserver;
@@ -109,29 +198,121 @@ namespace stormphrax {
     template <typename Observer>
     Position Position::applyMove(Move move, Observer observer) const {
         auto newPos = *this;
+        newPos.applyMoveInPlace(move, observer, *this);
+        return newPos;
+    }
+
+    template Position Position::applyMove<NullObserver>(Move, NullObserver) const;
+    template Position Position::applyMove<NnueObserver>(Move, NnueObserver) const;
+
+    void Position::makeMove(Move move, PositionUndo& undo) {
+        undo.keys = m_keys;
+        undo.checkZones = m_checkZones;
+        undo.checkers = m_checkers;
+        undo.pinned = m_pinned;
+        undo.threats = m_threats;
+        undo.castlingRooks = m_castlingRooks;
+        undo.halfmove = m_halfmove;
+        undo.enPassant = m_enPassant;
+        undo.kings = m_kings;
+        undo.threatsDirty = m_threatsDirty;
+        undo.checkZonesDirty = m_checkZonesDirty;
+
+        // NullObserver never looks at the pre-move position
+        undo.captured = applyMoveInPlace(move, NullObserver{}, *this);
+    }
+
+    void Position::unmakeMove(Move move, const PositionUndo& undo) {
+        m_stm = m_stm.flip();
+
+        const auto stm = m_stm;
 
-        newPos.m_stm = m_stm.flip();
-        newPos.m_keys.flipStm();
+        if (stm == Colors::kBlack) {
+            --m_fullmove;
+        }
+
+        if (move) {
+            const auto moveSrc = move.fromSq();
+            const auto moveDst = move.toSq();
+
+            switch (move.type()) {
+                case MoveType::kStandard: {
+                    movePieceInternal(moveDst, moveSrc, pieceOn(moveDst));
+                    if (undo.captured != Pieces::kNone) {
+                        setPieceInternal(moveDst, undo.captured);
+                    }
+                    break;
+                }
+                case MoveType::kPromotion: {
+                    removePieceInternal(moveDst, pieceOn(moveDst));
+                    setPieceInternal(moveSrc, PieceTypes::kPawn.withColor(stm));
+                    if (undo.captured != Pieces::kNone) {
+                        setPieceInternal(moveDst, undo.captured);
+                    }
+                    break;
+                }
+                case MoveType::kCastling: {
+                    // king and rook destinations may overlap either source in frc,
+                    // so remove both before putting either back
+                    const auto kingDst = m_kings.color(stm);
+                    const auto rookDst = kingDst.withFile(moveSrc.file() < moveDst.file() ? kFileF : kFileD);
+
+                    const auto king = PieceTypes::kKing.withColor(stm);
+                    const auto rook = PieceTypes::kRook.withColor(stm);
+
+                    removePieceInternal(kingDst, king);
+                    removePieceInternal(rookDst, rook);
+
+                    setPieceInternal(moveSrc, king);
+                    setPieceInternal(moveDst, rook);
 
-        if (newPos.m_enPassant != Squares::kNone) {
-            newPos.m_keys.flipEp(newPos.m_enPassant);
-            newPos.m_enPassant = Squares::kNone;
+                    break;
+                }
+                case MoveType::kEnPassant: {
+                    movePieceInternal(moveDst, moveSrc, PieceTypes::kPawn.withColor(stm));
+                    setPieceInternal(moveDst.flipRankParity(), undo.captured);
+                    break;
+                }
+            }
         }
 
-        const auto stm = newPos.nstm();
+        m_keys = undo.keys;
+        m_checkZones = undo.checkZones;
+        m_checkers = undo.checkers;
+        m_pinned = undo.pinned;
+        m_threats = undo.threats;
+        m_castlingRooks = undo.castlingRooks;
+        m_halfmove = undo.halfmove;
+        m_enPassant = undo.enPassant;
+        m_kings = undo.kings;
+        m_threatsDirty = undo.threatsDirty;
+        m_checkZonesDirty = undo.checkZonesDirty;
+    }
+
+    template <typename Observer>
+    Piece Position::applyMoveInPlace(Move move, Observer observer, const Position& before) {
+        const auto prevCastlingRooks = m_castlingRooks;
+
+        m_stm = m_stm.flip();
+        m_keys.flipStm();
+
+        if (m_enPassant != Squares::kNone) {
+            m_keys.flipEp(m_enPassant);
+            m_enPassant = Squares::kNone;
+        }
+
+        const auto stm = nstm();
         const auto nstm = stm.flip();
 
         if (stm == Colors::kBlack) {
-            ++newPos.m_fullmove;
+            ++m_fullmove;
         }
 
         if (!move) {
-            newPos.calcCheckersAndPins();
-            newPos.calcThreats();
+            calcCheckersAndPins();
+            invalidateLazyState();
 
-            newPos.calcCheckZones();
-
-            return newPos;
+            return Pieces::kNone;
         }
 
         const auto moveType = move.type();
@@ -146,59 +327,54 @@ namespace stormphrax {
 
         switch (moveType) {
             case MoveType::kStandard:
-                captured = newPos.movePiece<true, Observer>(moving, moveSrc, moveDst, observer);
+                captured = movePiece<true, Observer>(moving, moveSrc, moveDst, observer);
                 break;
             case MoveType::kPromotion:
-                captured = newPos.promotePawn<true, Observer>(moving, moveSrc, moveDst, move.promo(), observer);
+                captured = promotePawn<true, Observer>(moving, moveSrc, moveDst, move.promo(), observer);
                 break;
             case MoveType::kCastling:
-                newPos.castle<true, Observer>(moving, moveSrc, moveDst, observer);
+                castle<true, Observer>(moving, moveSrc, moveDst, observer);
                 break;
             case MoveType::kEnPassant:
-                captured = newPos.enPassant<true, Observer>(moving, moveSrc, moveDst, observer);
+                captured = enPassant<true, Observer>(moving, moveSrc, moveDst, observer);
                 break;
         }
 
         assert(captured.typeOrNone() != PieceTypes::kKing);
 
-        observer.finalize(*this, newPos);
+        observer.finalize(before, *this);
 
         if (movingType == PieceTypes::kRook) {
-            newPos.m_castlingRooks.color(stm).unset(moveSrc);
+            m_castlingRooks.color(stm).unset(moveSrc);
         } else if (movingType == PieceTypes::kKing) {
-            newPos.m_castlingRooks.color(stm).clear();
+            m_castlingRooks.color(stm).clear();
         } else if (movingType == PieceTypes::kPawn && std::abs(move.fromSqRank() - move.toSqRank()) == 2) {
-            newPos.m_enPassant = move.toSq().flipRankParity();
-            newPos.m_keys.flipEp(newPos.m_enPassant);
+            m_enPassant = move.toSq().flipRankParity();
+            m_keys.flipEp(m_enPassant);
         }
 
         if (captured == Pieces::kNone && moving.type() != PieceTypes::kPawn) {
-            ++newPos.m_halfmove;
+            ++m_halfmove;
         } else {
-            newPos.m_halfmove = 0;
+            m_halfmove = 0;
         }
 
         if (captured != Pieces::kNone && captured.type() == PieceTypes::kRook) {
-            newPos.m_castlingRooks.color(nstm).unset(moveDst);
+            m_castlingRooks.color(nstm).unset(moveDst);
         }
 
-        if (newPos.m_castlingRooks != m_castlingRooks) {
-            newPos.m_keys.switchCastling(m_castlingRooks, newPos.m_castlingRooks);
+        if (m_castlingRooks != prevCastlingRooks) {
+            m_keys.switchCastling(prevCastlingRooks, m_castlingRooks);
         }
 
-        newPos.calcCheckersAndPins();
-        newPos.calcThreats();
-
-        newPos.calcCheckZones();
+        calcCheckersAndPins();
+        invalidateLazyState();
 
-        newPos.filterEp(nstm);
+        filterEp(nstm);
 
-        return newPos;
+        return captured;
     }
 
-    template Position Position::applyMove<NullObserver>(Move, NullObserver) const;
-    template Position Position::applyMove<NnueObserver>(Move, NnueObserver) const;
-
     bool Position::isLegal(Move move) const {
         assert(move != kNullMove);
         assert(move.type() == MoveType::kPromotion || move.promoIdx() == 0);
@@ -297,16 +473,16 @@ namespace stormphrax {
                 const auto clearMask = toKingDst | toRook | kingDst.bit() | rookDst.bit();
                 const auto checkMask = toKingDst | kingDst.bit();
 
-                return (castleOcc & clearMask).empty() && (m_threats & checkMask).empty() && !pinned(us).hasSq(dst);
+                return (castleOcc & clearMask).empty() && (threats() & checkMask).empty() && !pinned(us).hasSq(dst);
             } else {
                 if (dst == m_castlingRooks.black().kingside) {
-                    return (occ & U64(0x6000000000000000)).empty() && (m_threats & U64(0x7000000000000000)).empty();
+                    return (occ & U64(0x6000000000000000)).empty() && (threats() & U64(0x7000000000000000)).empty();
                 } else if (dst == m_castlingRooks.black().queenside) {
-                    return (occ & U64(0x0E00000000000000)).empty() && (m_threats & U64(0x1C00000000000000)).empty();
+                    return (occ & U64(0x0E00000000000000)).empty() && (threats() & U64(0x1C00000000000000)).empty();
                 } else if (dst == m_castlingRooks.white().kingside) {
-                    return (occ & U64(0x0000000000000060)).empty() && (m_threats & U64(0x0000000000000070)).empty();
+                    return (occ & U64(0x0000000000000060)).empty() && (threats() & U64(0x0000000000000070)).empty();
                 } else {
-                    return (occ & U64(0x000000000000000E)).empty() && (m_threats & U64(0x000000000000001C)).empty();
+                    return (occ & U64(0x000000000000000E)).empty() && (threats() & U64(0x000000000000001C)).empty();
                 }
             }
         }
@@ -384,7 +560,7 @@ namespace stormphrax {
                     attacks = attacks::getQueenAttacks(src, occ);
                     break;
                 case PieceTypes::kKing.raw():
-                    attacks = attacks::getKingAttacks(src) & ~m_threats;
+                    attacks = attacks::getKingAttacks(src) & ~threats();
                     break;
                 default:
                     __builtin_unreachable();
@@ -496,7 +672,7 @@ namespace stormphrax {
 
         if constexpr (kThreatShortcut) {
             if (attacker != toMove) {
-                return m_threats.hasSq(sq);
+                return threats().hasSq(sq);
             }
         }
 
@@ -533,7 +709,7 @@ namespace stormphrax {
         assert(attacker != Colors::kNone);
 
         if (attacker == nstm()) {
-            return !(squares & m_threats).empty();
+            return !(squares & threats()).empty();
         }
 
         for (const auto sq : squares) {
@@ -572,15 +748,15 @@ namespace stormphrax {
 
             u32 slot = cuckoo::h1(diff);
 
-            if (diff != cuckoo::keys[slot]) {
+            if (diff != cuckoo::key(slot)) {
                 slot = cuckoo::h2(diff);
             }
 
-            if (diff != cuckoo::keys[slot]) {
+            if (diff != cuckoo::key(slot)) {
                 continue;
             }
 
-            const auto move = cuckoo::moves[slot];
+            const auto move = cuckoo::move(slot);
 
             if ((occ & rayBetween(move.fromSq(), move.toSq())).empty()) {
                 // repetition is after root, done
@@ -589,10 +765,9 @@ namespace stormphrax {
                 }
 
                 // otherwise, require a threefold
-                for (i32 i = d + 2; i <= end; ++i) {
-                    if (currKey == prevKey(i)) {
-                        return true;
-                    }
+                const auto size = static_cast<i32>(keys.size());
+                if (findKey<false>(keys, currKey, size - end, size - d - 2, [](i32) { return true; })) {
+                    return true;
                 }
             }
         }
@@ -601,21 +776,15 @@ namespace stormphrax {
     }
 
     bool Position::isDrawnByRepetition(i32 ply, std::span<const u64> keys) const {
-        const auto currKey = m_keys.all;
-        const auto limit = std::max(0, static_cast<i32>(keys.size()) - m_halfmove - 2);
-
-        ply -= 4;
+        const auto size = static_cast<i32>(keys.size());
+        const auto limit = std::max(0, size - m_halfmove - 2);
 
         i32 repetitions = 0;
 
-        for (auto i = static_cast<i32>(keys.size()) - 4; i >= limit; i -= 2, ply -= 2) {
+        return findKey<true>(keys, m_keys.all, limit, size - 4, [&](i32 idx) {
             // require a threefold repetition before root
-            if (keys[i] == currKey && ++repetitions == 1 + (ply < 0)) {
-                return true;
-            }
-        }
-
-        return false;
+            return ++repetitions == 1 + (ply - (size - idx) < 0);
+        });
     }
 
     bool Position::isDrawn(i32 ply, std::span<const u64> keys) const {
@@ -699,9 +868,9 @@ namespace stormphrax {
 
         const auto checkZone = [&] {
             if (movingPt == PieceTypes::kQueen) {
-                return m_checkZones[PieceTypes::kBishop.idx()] | m_checkZones[PieceTypes::kRook.idx()];
+                return checkZones()[PieceTypes::kBishop.idx()] | checkZones()[PieceTypes::kRook.idx()];
             }
-            return m_checkZones[movingPt.idx()];
+            return checkZones()[movingPt.idx()];
         }();
 
         return checkZone.hasSq(move.toSq());
@@ -1564,7 +1733,7 @@ namespace stormphrax {
         }
     }
 
-    void Position::calcThreats() {
+    void Position::calcThreats() const {
         const auto us = stm();
         const auto them = us.flip();
 
@@ -1593,9 +1762,11 @@ namespace stormphrax {
         }
 
         m_threats |= attacks::getKingAttacks(m_kings.color(them));
+
+        m_threatsDirty = false;
     }
 
-    void Position::calcCheckZones() {
+    void Position::calcCheckZones() const {
         const auto oppKingSq = king(nstm());
         const auto occ = this->occ();
 
@@ -1603,6 +1774,8 @@ namespace stormphrax {
         m_checkZones[1] = attacks::getKnightAttacks(oppKingSq);
         m_checkZones[2] = attacks::getBishopAttacks(oppKingSq, occ);
         m_checkZones[3] = attacks::getRookAttacks(oppKingSq, occ);
+
+        m_checkZonesDirty = false;
     }
 
     void Position::filterEp(Color capturing) {
@@ -339,6 +339,30 @@ namespace stormphrax {
 
     class BoardIterator;
 
+    // State overwritten by Position::makeMove that cannot be cheaply recomputed
+    // by Position::unmakeMove. Bitboards and the mailbox are reverted in place
+    struct PositionUndo {
+        Keys keys{};
+
+        std::array<Bitboard, 4> checkZones{};
+
+        Bitboard checkers{};
+        std::array<Bitboard, 2> pinned{};
+        Bitboard threats{};
+
+        CastlingRooks castlingRooks{};
+
+        u16 halfmove{};
+        Square enPassant{Squares::kNone};
+
+        KingPair kings{};
+
+        bool threatsDirty{};
+        bool checkZonesDirty{};
+
+        Piece captured{Pieces::kNone};
+    };
+
     class Position {
     public:
         Position() {
@@ -357,6 +381,12 @@ namespace stormphrax {
             return applyMove(kNullMove);
         }
 
+        // Experimental make/unmake alternative to applyMove. Moves are assumed
+        // to be legal, and must be unmade in reverse order with the same undo
+        // entry they were made with. Does not support observers
+        void makeMove(Move move, PositionUndo& undo);
+        void unmakeMove(Move move, const PositionUndo& undo);
+
         [[nodiscard]] bool isLegal(Move move) const;
 
         [[nodiscard]] inline Piece pieceOn(Square sq) const {
@@ -487,7 +517,13 @@ namespace stormphrax {
             return m_pinned;
         }
 
+        // Computed on first access after a move, as many positions
+        // are cut off (TT hits, stand pat) before they are needed
         [[nodiscard]] inline Bitboard threats() const {
+            if (m_threatsDirty) {
+                calcThreats();
+            }
+
             return m_threats;
         }
 
@@ -502,7 +538,14 @@ namespace stormphrax {
 
         [[nodiscard]] std::string toFen() const;
 
-        [[nodiscard]] inline bool operator==(const Position& other) const = default;
+        // Ignores lazily computed state
+        [[nodiscard]] inline bool operator==(const Position& other) const {
+            return m_bbs == other.m_bbs && m_mailbox == other.m_mailbox && m_keys == other.m_keys
+                && m_checkers == other.m_checkers && m_pinned == other.m_pinned
+                && m_castlingRooks == other.m_castlingRooks && m_halfmove == other.m_halfmove
+                && m_fullmove == other.m_fullmove && m_enPassant == other.m_enPassant && m_kings == other.m_kings
+                && m_stm == other.m_stm;
+        }
 
         void regen();
 
@@ -532,6 +575,11 @@ namespace stormphrax {
         [[nodiscard]] static std::optional<Position> fromDfrcIndex(u32 n);
 
     private:
+        // Applies a move to this position, with the pre-move position in before.
+        // Returns the captured piece, if any
+        template <typename Observer>
+        Piece applyMoveInPlace(Move move, Observer observer, const Position& before);
+
         template <bool kUpdateKeys = true>
         void setPiece(Piece piece, Square sq);
         template <bool kUpdateKeys = true>
@@ -553,8 +601,24 @@ namespace stormphrax {
         void removePieceInternal(Square sq, Piece piece);
 
         void calcCheckersAndPins();
-        void calcThreats();
-        void calcCheckZones();
+        void calcThreats() const;
+        void calcCheckZones() const;
+
+        // Threats and check zones are deferred until first use, and recalculated
+        // by their accessors if dirty. Resolving them writes to the position, so
+        // a dirty position must not be read from multiple threads at once
+        inline void invalidateLazyState() {
+            m_threatsDirty = true;
+            m_checkZonesDirty = true;
+        }
+
+        [[nodiscard]] inline const std::array<Bitboard, 4>& checkZones() const {
+            if (m_checkZonesDirty) {
+                calcCheckZones();
+            }
+
+            return m_checkZones;
+        }
 
         // Unsets ep squares if they are invalid (no pawn is able to capture)
         void filterEp(Color capturing);
@@ -567,17 +631,22 @@ namespace stormphrax {
         std::array<Piece, Squares::kCount> m_mailbox{};
 
         // pnbr
-        std::array<Bitboard, 4> m_checkZones{};
+        mutable std::array<Bitboard, 4> m_checkZones{};
 
         Keys m_keys{};
 
         Bitboard m_checkers{};
         std::array<Bitboard, 2> m_pinned{};
-        Bitboard m_threats{};
+        mutable Bitboard m_threats{};
 
         CastlingRooks m_castlingRooks{};
 
         u16 m_halfmove{};
+
+        // fills padding before m_fullmove
+        mutable bool m_threatsDirty{};
+        mutable bool m_checkZonesDirty{};
+
         u32 m_fullmove{1};
 
         Square m_enPassant{Squares::kNone};
@@ -58,6 +58,8 @@ namespace stormphrax::search {
 
     Searcher::Searcher(usize ttSizeMib) :
             m_ttable{ttSizeMib}, m_startTime{Instant::now()} {
+        allocCorrhists();
+
         m_threadData.resize(1);
         m_threads.emplace_back([this] { run(0); });
         m_initBarrier.arriveAndWait();
@@ -65,18 +67,37 @@ namespace stormphrax::search {
     }
 
     void Searcher::newGame() {
+#ifdef SP_SEARCH_STATS
+        m_searchStats.clear();
+#endif
+
         // Finalisation (init) clears the TT, so don't clear it twice
         if (!m_ttable.finalize()) {
             m_ttable.clear();
         }
 
-        for (i32 numaNode = 0; numaNode < numa::nodeCount(); ++numaNode) {
-            m_corrhists.get(numaNode)->clear();
-        }
+        // Threads have been taken for benching or datagen
+        if (m_threads.empty()) {
+            for (auto& corrhist : m_corrhists) {
+                corrhist.clear();
+            }
 
-        for (auto& thread : m_threadData) {
-            thread->history.clear();
+            for (auto& thread : m_threadData) {
+                thread->history.clear();
+            }
+
+            return;
         }
+
+        // Have each thread clear its own histories, and a share of the correction
+        // histories, rather than clearing them all serially from this thread
+        m_clearing.store(true, std::memory_order::relaxed);
+
+        m_resetBarrier.arriveAndWait();
+        m_idleBarrier.arriveAndWait();
+        m_setupBarrier.arriveAndWait();
+
+        m_clearing.store(false, std::memory_order::relaxed);
     }
 
     void Searcher::ensureReady() {
@@ -204,7 +225,7 @@ namespace stormphrax::search {
 
         thread->numaId = numaId;
         thread->nnueState.setNetwork(eval::getNetwork(numaId));
-        thread->correctionHistory = m_corrhists.get(numaId);
+        thread->correctionHistory = corrhistFor(numaId);
 
         return *thread;
     }
@@ -253,6 +274,7 @@ namespace stormphrax::search {
         m_multiPv = 1;
         m_contempt = {};
 
+        thread.nnueState.setRefreshTableSize(static_cast<u32>(g_opts.refreshTableSize));
         thread.nnueState.reset(thread.rootPos);
 
         m_runningThreads.store(1);
@@ -260,10 +282,18 @@ namespace stormphrax::search {
 
         m_startTime = Instant::now();
 
+#ifdef SP_SEARCH_STATS
+        thread.searchStats.clear();
+#endif
+
         searchRoot(thread, false);
 
         data.time = m_startTime.elapsed();
         data.nodes = thread.search.loadNodes();
+
+#ifdef SP_SEARCH_STATS
+        m_searchStats += thread.searchStats;
+#endif
     }
 
     void Searcher::setThreads(u32 threadCount) {
@@ -298,6 +328,73 @@ namespace stormphrax::search {
         m_initBarrier.arriveAndWait();
     }
 
+    void Searcher::setCorrhistSize(u32 sizeLog2) {
+        if (sizeLog2 == m_corrhistSizeLog2) {
+            return;
+        }
+
+        m_corrhistSizeLog2 = sizeLog2;
+        allocCorrhists();
+    }
+
+    void Searcher::setCorrhistShards(u32 shards) {
+        if (shards == m_corrhistShards) {
+            return;
+        }
+
+        m_corrhistShards = shards;
+        allocCorrhists();
+    }
+
+    void Searcher::allocCorrhists() {
+        using Entry = CorrectionHistoryTable::Entry;
+
+        const auto nodeCount = static_cast<u32>(numa::nodeCount());
+        const auto tableEntries = CorrectionHistoryTable::entryCount(m_corrhistSizeLog2);
+
+        // free the old tables first, they may be large
+        m_corrhists.clear();
+        m_corrhistEntries.reset();
+
+        m_corrhistEntries = std::make_unique<numa::NumaUniqueAllocation<Entry>>(tableEntries * m_corrhistShards);
+
+        m_corrhists.reserve(nodeCount * m_corrhistShards);
+
+        for (u32 node = 0; node < nodeCount; ++node) {
+            auto* entries = m_corrhistEntries->get(node);
+            for (u32 shard = 0; shard < m_corrhistShards; ++shard) {
+                m_corrhists.emplace_back(std::span{entries + shard * tableEntries, tableEntries}, m_corrhistSizeLog2);
+            }
+        }
+
+#ifdef SP_CORRHIST_STATS
+        const auto lines = tableEntries / CorrectionHistoryTable::kEntriesPerLine;
+
+        m_corrhistWriters = std::make_unique<std::atomic<u16>[]>(lines * m_corrhists.size());
+
+        for (usize idx = 0; idx < m_corrhists.size(); ++idx) {
+            m_corrhists[idx].setWriterTags(std::span{&m_corrhistWriters[idx * lines], lines});
+        }
+#endif
+
+        for (auto& thread : m_threadData) {
+            if (thread) {
+                thread->correctionHistory = corrhistFor(thread->numaId);
+            }
+        }
+    }
+
+    CorrectionHistoryTable* Searcher::corrhistFor(u32 numaId) {
+        // matches numa::bindThread, which places consecutive
+        // thread IDs on consecutive nodes, wrapping around
+        const auto nodeCount = static_cast<u32>(numa::nodeCount());
+
+        const auto node = numaId % nodeCount;
+        const auto shard = numaId / nodeCount % m_corrhistShards;
+
+        return &m_corrhists[node * m_corrhistShards + shard];
+    }
+
     void Searcher::populateDefaultRootMoves(const Position& pos) {
         ScoredMoveList generated{};
         generateAll(generated, pos);
@@ -379,7 +476,7 @@ namespace stormphrax::search {
         thread.numaId = threadId;
 
         thread.nnueState.setNetwork(eval::getNetwork(threadId));
-        thread.correctionHistory = m_corrhists.get(threadId);
+        thread.correctionHistory = corrhistFor(threadId);
 
         m_initBarrier.arriveAndWait();
 
@@ -391,6 +488,17 @@ namespace stormphrax::search {
                 return;
             }
 
+            if (m_clearing.load(std::memory_order::relaxed)) {
+                thread.history.clear();
+
+                for (usize idx = threadId; idx < m_corrhists.size(); idx += m_threads.size()) {
+                    m_corrhists[idx].clear();
+                }
+
+                m_setupBarrier.arriveAndWait();
+                continue;
+            }
+
             searchRoot(thread, true);
         }
     }
@@ -398,6 +506,12 @@ namespace stormphrax::search {
     Score Searcher::searchRoot(ThreadData& thread, bool actualSearch) {
         if (actualSearch) {
             thread.search = SearchData{};
+#ifdef SP_CORRHIST_STATS
+            thread.corrhistWrites = {};
+#endif
+#ifdef SP_SEARCH_STATS
+            thread.searchStats.clear();
+#endif
             thread.rootPos = m_setupInfo.rootPos;
 
             thread.keyHistory.clear();
@@ -405,6 +519,7 @@ namespace stormphrax::search {
 
             std::ranges::copy(m_setupInfo.keyHistory, std::back_inserter(thread.keyHistory));
 
+            thread.nnueState.setRefreshTableSize(static_cast<u32>(g_opts.refreshTableSize));
             thread.nnueState.reset(thread.rootPos);
 
             m_setupBarrier.arriveAndWait();
@@ -502,6 +617,10 @@ namespace stormphrax::search {
                         m_stop.store(true, std::memory_order::relaxed);
                     }
 
+                    if (thread.isMainThread() && !hasStopped()) {
+                        m_iterationLog.recordWindow(thread.pvIdx, alpha, beta, score);
+                    }
+
                     if ((score > alpha && score < beta) || hasStopped()) {
                         break;
                     }
@@ -539,6 +658,8 @@ namespace stormphrax::search {
                         if (depth >= m_maxDepth || m_limiter->stopSoft(nodes)) {
                             m_stop.store(true, std::memory_order::relaxed);
                         }
+
+                        m_iterationLog.writeIteration(thread, depth, nodes, elapsed(), *m_limiter, hasStopped());
                     }
 
                     if (!m_silent
@@ -583,6 +704,22 @@ namespace stormphrax::search {
             m_stop.store(true, std::memory_order::seq_cst);
             waitForThreads();
 
+#ifdef SP_CORRHIST_STATS
+            reportCorrhistWrites();
+#endif
+
+#ifdef SP_TIME_CHECK_STATS
+            reportTimeChecks();
+#endif
+
+#ifdef SP_SEARCH_STATS
+            for (const auto& data : m_threadData) {
+                m_searchStats += data->searchStats;
+            }
+#endif
+
+            m_iterationLog.writeEnd(thread, elapsed());
+
             finalReport();
 
             m_ttable.age();
@@ -846,7 +983,9 @@ namespace stormphrax::search {
                 return margin;
             };
 
-            if (depth <= 12 && curr.staticEval - rfpMargin() >= beta) {
+            if (depth <= 12
+                && thread.searchStats.record(SearchStat::kRfp, depth, curr.staticEval - rfpMargin() >= beta))
+            {
                 return !isDecisive(curr.staticEval) && !isDecisive(beta)
                          ? util::ilerp<1024>(curr.staticEval, beta, rfpFailFirmT())
                          : curr.staticEval;
@@ -856,7 +995,7 @@ namespace stormphrax::search {
                 && curr.staticEval + razoringMargin() * depth <= alpha)
             {
                 const auto score = qsearch(thread, pos, pv, ply, moveStackIdx, alpha, alpha + 1);
-                if (score <= alpha) {
+                if (thread.searchStats.record(SearchStat::kRazoring, depth, score <= alpha)) {
                     return score;
                 }
             }
@@ -895,7 +1034,7 @@ namespace stormphrax::search {
                     return 0;
                 }
 
-                if (score >= beta) {
+                if (thread.searchStats.record(SearchStat::kNmp, depth, score >= beta)) {
                     if (depth <= 14 || thread.minNmpPly > 0) {
                         return isWin(score) ? beta : score;
                     }
@@ -962,9 +1101,12 @@ namespace stormphrax::search {
                     if (score >= probcutBeta) {
                         m_ttable
                             .put(pos.key(), score, rawStaticEval, move, probcutDepth, ply, TtFlag::kLowerBound, false);
+                        thread.searchStats.record(SearchStat::kProbcut, depth, true);
                         return score;
                     }
                 }
+
+                thread.searchStats.record(SearchStat::kProbcut, depth, false);
             }
         }
 
@@ -1001,7 +1143,7 @@ namespace stormphrax::search {
 
             const auto captured = pos.captureTarget(move);
 
-            const auto baseLmr = g_lmrTable[noisy][depth][legalMoves + 1];
+            const i32 baseLmr = g_lmrTable[noisy][depth][legalMoves + 1];
 
             const auto history = [&] {
                 if (noisy) {
@@ -1029,24 +1171,43 @@ namespace stormphrax::search {
                 }();
 
                 if (!noisy) {
-                    if (legalMoves >= kLmpTable[improving][std::min(depth, 15)] + history * lmpHistoryScale() / 8388608)
-                    {
+                    const auto lmpLimit =
+                        kLmpTable[improving][std::min(depth, 15)] + history * lmpHistoryScale() / 8388608;
+
+                    if (thread.searchStats.record(SearchStat::kLmp, depth, legalMoves >= lmpLimit)) {
                         generator.skipQuiets();
                         continue;
                     }
 
-                    if (lmrDepth <= 5 && history < quietHistPruningMargin() * depth + quietHistPruningOffset()) {
+                    if (lmrDepth <= 5
+                        && thread.searchStats.record(
+                            SearchStat::kQuietHistoryPruning,
+                            depth,
+                            history < quietHistPruningMargin() * depth + quietHistPruningOffset()
+                        ))
+                    {
                         generator.skipQuiets();
                         continue;
                     }
 
                     if (!inCheck && lmrDepth <= 8 && std::abs(alpha) < 2000 && !pos.givesDirectCheck(move)
-                        && curr.staticEval + fpMargin() + depth * fpScale() + history / fpHistoryDivisor() <= alpha)
+                        && thread.searchStats.record(
+                            SearchStat::kFutilityPruning,
+                            depth,
+                            curr.staticEval + fpMargin() + depth * fpScale() + history / fpHistoryDivisor() <= alpha
+                        ))
                     {
                         generator.skipQuiets();
                         continue;
                     }
-                } else if (depth <= 4 && history < noisyHistPruningMargin() * depth * depth + noisyHistPruningOffset())
+                } else if (
+                    depth <= 4
+                    && thread.searchStats.record(
+                        SearchStat::kNoisyHistoryPruning,
+                        depth,
+                        history < noisyHistPruningMargin() * depth * depth + noisyHistPruningOffset()
+                    )
+                )
                 {
                     continue;
                 }
@@ -1055,7 +1216,9 @@ namespace stormphrax::search {
                     noisy ? std::min(seePruningThresholdNoisy() * depth - history / seePruningNoisyHistDivisor(), 0)
                           : seePruningThresholdQuiet() * lmrDepth * lmrDepth;
 
-                if (quietOrLosing && !see::see(pos, move, seeThreshold)) {
+                if (quietOrLosing
+                    && thread.searchStats.record(SearchStat::kSeePruning, depth, !see::see(pos, move, seeThreshold)))
+                {
                     continue;
                 }
             }
@@ -1094,7 +1257,7 @@ namespace stormphrax::search {
 
                     curr.excluded = kNullMove;
 
-                    if (score < sBeta) {
+                    if (thread.searchStats.record(SearchStat::kSingular, depth, score < sBeta)) {
                         const auto corr = complexity.value_or(0);
                         const auto doubleCorr =
                             static_cast<i32>(static_cast<i64>(corr) * doubleExtCorrScale() / 16777216);
@@ -1110,7 +1273,7 @@ namespace stormphrax::search {
                                                 + ttMoveNoisy * tripleExtNoisyMargin()                 //
                                                 - tripleCorr;
                         extension = 1 + (score < sBeta - doubleMargin) + (score < sBeta - tripleMargin);
-                    } else if (!kPvNode && score >= beta) {
+                    } else if (!kPvNode && thread.searchStats.record(SearchStat::kMulticut, depth, score >= beta)) {
                         return !isDecisive(score) ? util::ilerp<1024>(score, beta, multicutFailFirmT()) : score;
                     } else if (ttEntry.score >= beta) {
                         extension = -3;
@@ -1186,7 +1349,7 @@ namespace stormphrax::search {
                         -search(thread, newPos, curr.pv, reduced, ply + 1, moveStackIdx + 1, -alpha - 1, -alpha, true);
                     curr.reduction = 0;
 
-                    if (score > alpha) {
+                    if (thread.searchStats.record(SearchStat::kLmrResearch, depth, score > alpha)) {
                         const bool doDeeperSearch = score > bestScore + lmrDeeperBase() + lmrDeeperScale() * newDepth;
                         const bool doShallowerSearch = score < bestScore + newDepth;
 
@@ -1437,6 +1600,14 @@ namespace stormphrax::search {
                     || (ttFlag == TtFlag::kLowerBound && bestScore > curr.staticEval)))
             {
                 thread.correctionHistory->update(pos, thread.keyHistory, depth, bestScore, curr.staticEval);
+#ifdef SP_CORRHIST_STATS
+                thread.correctionHistory->recordWrites(
+                    pos,
+                    thread.keyHistory,
+                    static_cast<u16>(thread.id + 1),
+                    thread.corrhistWrites
+                );
+#endif
             }
 
             if (!kRootNode || thread.pvIdx == 0) {
@@ -1880,4 +2051,45 @@ namespace stormphrax::search {
 
         println("bestmove {}", bestThread.pvMove().move());
     }
+
+#ifdef SP_TIME_CHECK_STATS
+    void Searcher::reportTimeChecks() {
+        if (m_silent) {
+            return;
+        }
+
+        const auto& stats = m_limiter->timeCheckStats();
+        const auto time = elapsed();
+
+        println(
+            "info string {} time checks ({:.2f}/ms), hard time limit {}",
+            stats.checks,
+            time > 0.0 ? static_cast<f64>(stats.checks) / (time * 1000.0) : 0.0,
+            stats.overshoot ? fmt::format("overshot by {:.3f} ms at {} nodes", *stats.overshoot * 1000.0, stats.nodes)
+                            : "not hit"
+        );
+    }
+#endif
+
+#ifdef SP_CORRHIST_STATS
+    void Searcher::reportCorrhistWrites() {
+        if (m_silent) {
+            return;
+        }
+
+        CorrectionHistoryTable::WriteStats total{};
+
+        for (const auto& thread : m_threadData) {
+            total.writes += thread->corrhistWrites.writes;
+            total.foreignWrites += thread->corrhistWrites.foreignWrites;
+        }
+
+        println(
+            "info string corrhist {} shard(s) per node, {} line writes, {:.2f}% foreign",
+            m_corrhistShards,
+            total.writes,
+            total.writes == 0 ? 0.0 : static_cast<f64>(total.foreignWrites) * 100.0 / static_cast<f64>(total.writes)
+        );
+    }
+#endif
 } // namespace stormphrax::search
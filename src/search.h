@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "eval/eval.h"
+#include "iteration_log.h"
 #include "limit.h"
 #include "position.h"
 #include "tb.h"
@@ -113,10 +114,30 @@ namespace stormphrax::search {
             m_ttable.resize(mib);
         }
 
+        void setCorrhistSize(u32 sizeLog2);
+        void setCorrhistShards(u32 shards);
+
         inline void setSilent(bool silent) {
             m_silent = silent;
         }
 
+        // Empty to disable
+        inline bool setIterationLog(std::string_view path) {
+            if (path.empty()) {
+                m_iterationLog.close();
+                return true;
+            }
+
+            return m_iterationLog.open(path);
+        }
+
+#ifdef SP_SEARCH_STATS
+        // Totals over every search since the last new game
+        [[nodiscard]] inline const SearchStats& searchStats() const {
+            return m_searchStats;
+        }
+#endif
+
         inline void quit() {
             m_quit.store(true, std::memory_order::release);
 
@@ -135,6 +156,7 @@ namespace stormphrax::search {
         mutable std::mutex m_searchMutex{};
 
         std::atomic_bool m_quit{};
+        std::atomic_bool m_clearing{};
         std::atomic_bool m_searching{};
 
         util::Instant m_startTime;
@@ -155,6 +177,8 @@ namespace stormphrax::search {
 
         std::optional<limit::SearchLimiter> m_limiter{};
 
+        IterationLog m_iterationLog{};
+
         bool m_infinite{};
         i32 m_maxDepth{kMaxDepth};
 
@@ -172,7 +196,23 @@ namespace stormphrax::search {
 
         SetupInfo m_setupInfo{};
 
-        numa::NumaUniqueAllocation<CorrectionHistoryTable> m_corrhists{};
+        u32 m_corrhistSizeLog2{kDefaultCorrhistSizeLog2};
+        u32 m_corrhistShards{kDefaultCorrhistShards};
+
+        std::unique_ptr<numa::NumaUniqueAllocation<CorrectionHistoryTable::Entry>> m_corrhistEntries{};
+        // [node][shard]
+        std::vector<CorrectionHistoryTable> m_corrhists{};
+
+#ifdef SP_CORRHIST_STATS
+        std::unique_ptr<std::atomic<u16>[]> m_corrhistWriters{};
+#endif
+
+#ifdef SP_SEARCH_STATS
+        SearchStats m_searchStats{};
+#endif
+
+        void allocCorrhists();
+        [[nodiscard]] CorrectionHistoryTable* corrhistFor(u32 numaId);
 
         void populateDefaultRootMoves(const Position& pos);
         void rankTbMoves(const Position& pos, std::span<const u64> keys);
@@ -233,5 +273,13 @@ namespace stormphrax::search {
 
         const ThreadData& selectThread() const;
         void finalReport();
+
+#ifdef SP_CORRHIST_STATS
+        void reportCorrhistWrites();
+#endif
+
+#ifdef SP_TIME_CHECK_STATS
+        void reportTimeChecks();
+#endif
     };
 } // namespace stormphrax::search
@@ -0,0 +1,95 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "search_stats.h"
+
+#ifdef SP_SEARCH_STATS
+    #include <array>
+    #include <string_view>
+
+namespace stormphrax::search {
+    namespace {
+        constexpr std::array kStatNames = {
+            std::string_view{"reverse futility pruning"},
+            std::string_view{"razoring"},
+            std::string_view{"null move pruning"},
+            std::string_view{"probcut"},
+            std::string_view{"late move pruning"},
+            std::string_view{"quiet history pruning"},
+            std::string_view{"futility pruning"},
+            std::string_view{"noisy history pruning"},
+            std::string_view{"SEE pruning"},
+            std::string_view{"singular extensions"},
+            std::string_view{"multicut"},
+            std::string_view{"LMR re-searches"},
+        };
+
+        static_assert(kStatNames.size() == static_cast<usize>(SearchStat::kCount));
+
+        [[nodiscard]] inline f64 percent(u64 hits, u64 tried) {
+            return tried == 0 ? 0.0 : static_cast<f64>(hits) * 100.0 / static_cast<f64>(tried);
+        }
+    } // namespace
+
+    SearchStats& SearchStats::operator+=(const SearchStats& other) {
+        for (usize stat = 0; stat < m_counts.size(); ++stat) {
+            for (usize bucket = 0; bucket < kDepthBuckets; ++bucket) {
+                m_counts[stat][bucket].tried += other.m_counts[stat][bucket].tried;
+                m_counts[stat][bucket].hits += other.m_counts[stat][bucket].hits;
+            }
+        }
+
+        return *this;
+    }
+
+    void SearchStats::print() const {
+        for (usize stat = 0; stat < m_counts.size(); ++stat) {
+            u64 tried{};
+            u64 hits{};
+
+            for (const auto& counts : m_counts[stat]) {
+                tried += counts.tried;
+                hits += counts.hits;
+            }
+
+            if (tried == 0) {
+                continue;
+            }
+
+            println("{}: {} tried, {} hits ({:.2f}%)", kStatNames[stat], tried, hits, percent(hits, tried));
+
+            for (usize bucket = 0; bucket < kDepthBuckets; ++bucket) {
+                const auto& counts = m_counts[stat][bucket];
+
+                if (counts.tried == 0) {
+                    continue;
+                }
+
+                println(
+                    "    depth {:>2}{} {:>12} tried {:>12} hits ({:6.2f}%)",
+                    bucket,
+                    bucket == kDepthBuckets - 1 ? "+" : ":",
+                    counts.tried,
+                    counts.hits,
+                    percent(counts.hits, counts.tried)
+                );
+            }
+        }
+    }
+} // namespace stormphrax::search
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <algorithm>
+
+#include "util/multi_array.h"
+
+namespace stormphrax::search {
+    // Each rule is counted when it is tried (its preconditions held and it was
+    // evaluated), and again when it hit (pruned, cut off or extended)
+    enum class SearchStat : u8 {
+        kRfp = 0,
+        kRazoring,
+        // hit = null move search failed high
+        kNmp,
+        kProbcut,
+        kLmp,
+        kQuietHistoryPruning,
+        kFutilityPruning,
+        kNoisyHistoryPruning,
+        kSeePruning,
+        // hit = extended
+        kSingular,
+        // hit = cut off by multicut
+        kMulticut,
+        // hit = reduced search failed high
+        kLmrResearch,
+        kCount,
+    };
+
+#ifdef SP_SEARCH_STATS
+    // Per-thread counters, merged into the searcher's totals after each search
+    class SearchStats {
+    public:
+        // depths past the last bucket are counted in it
+        static constexpr usize kDepthBuckets = 32;
+
+        // Returns hit, so that conditions can be wrapped in place
+        inline bool record(SearchStat stat, i32 depth, bool hit) {
+            const auto bucket = static_cast<usize>(std::clamp(depth, 0, static_cast<i32>(kDepthBuckets) - 1));
+            auto& counts = m_counts[static_cast<usize>(stat)][bucket];
+
+            ++counts.tried;
+            counts.hits += hit;
+
+            return hit;
+        }
+
+        inline void clear() {
+            m_counts = {};
+        }
+
+        SearchStats& operator+=(const SearchStats& other);
+
+        void print() const;
+
+    private:
+        struct Counts {
+            u64 tried;
+            u64 hits;
+        };
+
+        util::MultiArray<Counts, static_cast<usize>(SearchStat::kCount), kDepthBuckets> m_counts{};
+    };
+#else
+    class SearchStats {
+    public:
+        inline bool record(SearchStat stat, i32 depth, bool hit) {
+            SP_UNUSED(stat, depth);
+            return hit;
+        }
+    };
+#endif
+} // namespace stormphrax::search
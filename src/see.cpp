@@ -18,6 +18,10 @@
 
 #include "see.h"
 
+#include <array>
+#include <cassert>
+#include <optional>
+
 #include "attacks/attacks.h"
 #include "rays.h"
 
@@ -59,75 +63,169 @@ namespace stormphrax::see {
         return score;
     }
 
-    bool see(const Position& pos, Move move, Score threshold) {
-        const auto color = pos.stm();
+    namespace {
+        // Plays out the capture sequence on sq after the initial capture, which
+        // left the side to move with score and is already reflected in occ
+        [[nodiscard]] bool resolve(
+            const Position& pos,
+            Square sq,
+            Bitboard occ,
+            Bitboard attackers,
+            Bitboard bishops,
+            Bitboard rooks,
+            i32 score
+        ) {
+            const auto color = pos.stm();
+            auto us = color.flip();
+
+            while (true) {
+                const auto ourAttackers = attackers & pos.bb(us);
 
-        auto score = gain(pos, move) - threshold;
+                if (ourAttackers.empty()) {
+                    break;
+                }
+
+                const auto next = popLeastValuable(pos, occ, ourAttackers, us);
+
+                if (next == PieceTypes::kPawn || next == PieceTypes::kBishop || next == PieceTypes::kQueen) {
+                    attackers |= attacks::getBishopAttacks(sq, occ) & bishops;
+                }
+
+                if (next == PieceTypes::kRook || next == PieceTypes::kQueen) {
+                    attackers |= attacks::getRookAttacks(sq, occ) & rooks;
+                }
 
-        if (score < 0) {
-            return false;
+                attackers &= occ;
+
+                score = -score - 1 - value(next);
+                us = us.flip();
+
+                if (score >= 0) {
+                    // our only attacker is our king, but the opponent still has defenders
+                    if (next == PieceTypes::kKing && !(attackers & pos.bb(us)).empty()) {
+                        us = us.flip();
+                    }
+                    break;
+                }
+            }
+
+            return color != us;
         }
 
-        auto next = move.type() == MoveType::kPromotion ? move.promo() : pos.pieceOn(move.fromSq()).type();
+        // Returns the result if it is known without looking at any other attackers,
+        // otherwise sets score to the score for the side to move after the initial capture
+        [[nodiscard]] inline std::optional<bool> trivialResult(
+            const Position& pos,
+            Move move,
+            Score threshold,
+            i32& score
+        ) {
+            score = gain(pos, move) - threshold;
+
+            if (score < 0) {
+                return false;
+            }
+
+            const auto next = move.type() == MoveType::kPromotion ? move.promo() : pos.pieceOn(move.fromSq()).type();
 
-        score -= value(next);
+            score -= value(next);
 
-        if (score >= 0) {
-            return true;
+            if (score >= 0) {
+                return true;
+            }
+
+            return {};
+        }
+
+        [[nodiscard]] inline Bitboard unpinnedAttackers(const Position& pos, Square sq) {
+            const auto blackPinned = pos.pinned(Colors::kBlack);
+            const auto whitePinned = pos.pinned(Colors::kWhite);
+
+            const auto blackKingRay = rayIntersecting(pos.blackKing(), sq);
+            const auto whiteKingRay = rayIntersecting(pos.whiteKing(), sq);
+
+            return ~(blackPinned | whitePinned) | (blackPinned & blackKingRay) | (whitePinned & whiteKingRay);
+        }
+
+        // The rest of Position::allAttackersTo, which does not depend on occupancy
+        [[nodiscard]] inline Bitboard nonSliderAttackers(const Position& pos, Square sq) {
+            const auto& bbs = pos.bbs();
+
+            return (bbs.blackPawns() & attacks::getPawnAttacks(sq, Colors::kWhite))
+                 | (bbs.whitePawns() & attacks::getPawnAttacks(sq, Colors::kBlack))
+                 | (bbs.knights() & attacks::getKnightAttacks(sq))
+                 | (bbs.kings() & attacks::getKingAttacks(sq));
+        }
+    } // namespace
+
+    bool see(const Position& pos, Move move, Score threshold) {
+        i32 score;
+
+        if (const auto result = trivialResult(pos, move, threshold, score)) {
+            return *result;
         }
 
         const auto sq = move.toSq();
 
-        auto occ = pos.occ() ^ move.fromSq().bit() ^ sq.bit();
+        const auto occ = pos.occ() ^ move.fromSq().bit() ^ sq.bit();
 
         const auto queens = pos.bb(PieceTypes::kQueen);
 
         const auto bishops = queens | pos.bb(PieceTypes::kBishop);
         const auto rooks = queens | pos.bb(PieceTypes::kRook);
 
-        const auto blackPinned = pos.pinned(Colors::kBlack);
-        const auto whitePinned = pos.pinned(Colors::kWhite);
+        const auto attackers = pos.allAttackersTo(sq, occ) & unpinnedAttackers(pos, sq);
 
-        const auto blackKingRay = rayIntersecting(pos.blackKing(), sq);
-        const auto whiteKingRay = rayIntersecting(pos.whiteKing(), sq);
+        return resolve(pos, sq, occ, attackers, bishops, rooks, score);
+    }
 
-        const auto allowed = ~(blackPinned | whitePinned) | (blackPinned & blackKingRay) | (whitePinned & whiteKingRay);
+    void see(
+        const Position& pos,
+        std::span<const Move> moves,
+        std::span<const Score> thresholds,
+        std::span<bool> results
+    ) {
+        assert(thresholds.size() == moves.size());
+        assert(results.size() >= moves.size());
 
-        auto attackers = pos.allAttackersTo(sq, occ) & allowed;
+        const auto occ = pos.occ();
 
-        auto us = color.flip();
+        const auto queens = pos.bb(PieceTypes::kQueen);
 
-        while (true) {
-            const auto ourAttackers = attackers & pos.bb(us);
+        const auto bishops = queens | pos.bb(PieceTypes::kBishop);
+        const auto rooks = queens | pos.bb(PieceTypes::kRook);
 
-            if (ourAttackers.empty()) {
-                break;
-            }
+        // pin filter and non-slider attackers of each target square, which do
+        // not depend on the moving piece, filled on first use of that square
+        Bitboard cached{};
+        std::array<Bitboard, Squares::kCount> targetAllowed;
+        std::array<Bitboard, Squares::kCount> targetNonSliders;
 
-            next = popLeastValuable(pos, occ, ourAttackers, us);
+        for (usize i = 0; i < moves.size(); ++i) {
+            const auto move = moves[i];
 
-            if (next == PieceTypes::kPawn || next == PieceTypes::kBishop || next == PieceTypes::kQueen) {
-                attackers |= attacks::getBishopAttacks(sq, occ) & bishops;
+            i32 score;
+
+            if (const auto result = trivialResult(pos, move, thresholds[i], score)) {
+                results[i] = *result;
+                continue;
             }
 
-            if (next == PieceTypes::kRook || next == PieceTypes::kQueen) {
-                attackers |= attacks::getRookAttacks(sq, occ) & rooks;
+            const auto sq = move.toSq();
+
+            if (!cached.hasSq(sq)) {
+                targetAllowed[sq.idx()] = unpinnedAttackers(pos, sq);
+                targetNonSliders[sq.idx()] = nonSliderAttackers(pos, sq) & targetAllowed[sq.idx()];
+                cached.setSq(sq);
             }
 
-            attackers &= occ;
+            const auto moveOcc = occ ^ move.fromSq().bit() ^ sq.bit();
 
-            score = -score - 1 - value(next);
-            us = us.flip();
+            const auto sliders = (attacks::getBishopAttacks(sq, moveOcc) & bishops)
+                               | (attacks::getRookAttacks(sq, moveOcc) & rooks);
+            const auto attackers = targetNonSliders[sq.idx()] | (sliders & targetAllowed[sq.idx()]);
 
-            if (score >= 0) {
-                // our only attacker is our king, but the opponent still has defenders
-                if (next == PieceTypes::kKing && !(attackers & pos.bb(us)).empty()) {
-                    us = us.flip();
-                }
-                break;
-            }
+            results[i] = resolve(pos, sq, moveOcc, attackers, bishops, rooks, score);
         }
-
-        return color != us;
     }
 } // namespace stormphrax::see
@@ -20,6 +20,8 @@
 
 #include "types.h"
 
+#include <span>
+
 #include "core.h"
 #include "position.h"
 #include "tunable.h"
@@ -35,4 +37,8 @@ namespace stormphrax::see {
 
     [[nodiscard]] i32 gain(const Position& pos, Move move);
     [[nodiscard]] bool see(const Position& pos, Move move, Score threshold);
+
+    // Batched see(), writing the result for moves[i] against thresholds[i] to results[i]. The
+    // non-slider attackers of each target square and their pin filtering are only computed once
+    void see(const Position& pos, std::span<const Move> moves, std::span<const Score> thresholds, std::span<bool> results);
 } // namespace stormphrax::see
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <tuple>
+#include <utility>
 
 namespace stormphrax::search {
     std::pair<Position, ThreadPosGuard<false>> ThreadData::applyNullmove(const Position& pos, i32 ply) {
@@ -36,9 +37,14 @@ namespace stormphrax::search {
 
         keyHistory.push_back(pos.key());
 
+        auto newPos = pos.applyNullMove();
+#ifdef SP_PACKED_CORRHIST
+        correctionHistory->prefetch(newPos);
+#endif
+
         return std::pair<Position, ThreadPosGuard<false>>{
             std::piecewise_construct,
-            std::forward_as_tuple(pos.applyNullMove()),
+            std::forward_as_tuple(std::move(newPos)),
             std::forward_as_tuple(keyHistory, nnueState)
         };
     }
@@ -59,9 +65,14 @@ namespace stormphrax::search {
 
         keyHistory.push_back(pos.key());
 
+        auto newPos = pos.applyMove(move, nnueState.push());
+#ifdef SP_PACKED_CORRHIST
+        correctionHistory->prefetch(newPos);
+#endif
+
         return std::pair<Position, ThreadPosGuard<true>>{
             std::piecewise_construct,
-            std::forward_as_tuple(pos.applyMove(move, nnueState.push())),
+            std::forward_as_tuple(std::move(newPos)),
             std::forward_as_tuple(keyHistory, nnueState)
         };
     }
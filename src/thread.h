@@ -30,6 +30,7 @@
 #include "movepick.h"
 #include "pv.h"
 #include "root_move.h"
+#include "search_stats.h"
 
 namespace stormphrax::search {
     struct SearchData {
@@ -165,6 +166,13 @@ namespace stormphrax::search {
 
         CorrectionHistoryTable* correctionHistory{};
 
+#ifdef SP_CORRHIST_STATS
+        CorrectionHistoryTable::WriteStats corrhistWrites{};
+#endif
+
+        // Empty unless built with SP_SEARCH_STATS
+        SearchStats searchStats{};
+
         Position rootPos{};
 
         std::vector<u64> keyHistory{};
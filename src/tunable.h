@@ -21,8 +21,10 @@
 #include "types.h"
 
 #include <array>
+#include <limits>
 
 #include "core.h"
+#include "util/cemath.h"
 #include "util/multi_array.h"
 
 #ifndef SP_EXTERNAL_TUNE
@@ -41,16 +43,92 @@ namespace stormphrax::tunable {
     void init();
 
     // [noisy][depth][legal moves]
-    extern util::MultiArray<i32, 2, 256, 256> g_lmrTable;
+    // reductions are in 1024ths of a ply, and fit in an i16 for every value
+    // the base and divisor params can take, which halves the table's size
+    using LmrTable = util::MultiArray<i16, 2, 256, 256>;
 
     // [coloured piece], +1 for none
-    extern std::array<i32, 13> g_seeValues;
-    extern std::array<PieceType, PieceTypes::kCount> g_seeOrderedPts;
+    using SeeValueTable = std::array<i32, 13>;
+    using SeeOrderTable = std::array<PieceType, PieceTypes::kCount>;
+
+    namespace internal {
+        // base and divisor in hundredths
+        constexpr void fillLmrTable(util::MultiArray<i16, 256, 256>& table, i32 base, i32 divisor) {
+            std::array<f64, 256> lns{};
+
+            for (i32 i = 1; i < 256; ++i) {
+                lns[i] = util::ln(static_cast<f64>(i));
+            }
+
+            const auto b = static_cast<f64>(base) / 100.0;
+            const auto d = static_cast<f64>(divisor) / 100.0;
+
+            for (i32 depth = 1; depth < 256; ++depth) {
+                for (i32 moves = 1; moves < 256; ++moves) {
+                    const auto r = 1024.0 * (b + lns[depth] * lns[moves] / d);
+                    table[depth][moves] = static_cast<i16>(r < -32768.0 ? -32768 : r > 32767.0 ? 32767 : r);
+                }
+            }
+        }
+
+        constexpr void fillSeeTables(
+            SeeValueTable& seeValues,
+            SeeOrderTable& orderedPts,
+            const std::array<i32, 5>& values
+        ) {
+            seeValues.fill(0);
+
+            for (usize i = 0; i < values.size(); ++i) {
+                seeValues[i * 2 + 0] = values[i];
+                seeValues[i * 2 + 1] = values[i];
+            }
+
+            orderedPts = {
+                PieceTypes::kPawn,
+                PieceTypes::kKnight,
+                PieceTypes::kBishop,
+                PieceTypes::kRook,
+                PieceTypes::kQueen,
+                PieceTypes::kKing,
+            };
+
+            // ascending by value, king last, ties broken by piece type.
+            // std::ranges::stable_sort is not constexpr until C++26
+            const auto key = [&](PieceType pt) {
+                return pt == PieceTypes::kKing ? std::numeric_limits<i32>::max()
+                                               : values[pt.idx()] * 10000 + static_cast<i32>(pt.idx());
+            };
+
+            for (usize i = 1; i < orderedPts.size(); ++i) {
+                const auto pt = orderedPts[i];
+
+                auto j = i;
+                for (; j > 0 && key(orderedPts[j - 1]) > key(pt); --j) {
+                    orderedPts[j] = orderedPts[j - 1];
+                }
+
+                orderedPts[j] = pt;
+            }
+        }
+    } // namespace internal
+
+    // constant-initialised in tunable.cpp outside tunable builds, rather than here,
+    // so that the table is only generated by the compiler once
+#if SP_EXTERNAL_TUNE
+    extern LmrTable g_lmrTable;
+#else
+    extern const LmrTable g_lmrTable;
+#endif
+
+#if SP_EXTERNAL_TUNE
+    extern SeeValueTable g_seeValues;
+    extern SeeOrderTable g_seeOrderedPts;
 
     void updateQuietLmrTable();
     void updateNoisyLmrTable();
 
     void updateSeeTables();
+#endif
 
 #define SP_TUNABLE_ASSERTS(Default, Min, Max, Step) \
     static_assert((Default) >= (Min)); \
@@ -379,6 +457,32 @@ namespace stormphrax::tunable {
 
     SP_TUNABLE_PARAM(threadWeightScoreOffset, 11, 0, 20, 1)
 
+#if !SP_EXTERNAL_TUNE
+    // every param is constant outside tunable builds, so the tables derived from them can be
+    // too. These are small enough to define here, so their values fold into SEE directly
+    namespace internal {
+        struct SeeTables {
+            SeeValueTable values;
+            SeeOrderTable orderedPts;
+        };
+
+        inline constexpr SeeTables kSeeTables = [] {
+            SeeTables tables{};
+
+            fillSeeTables(
+                tables.values,
+                tables.orderedPts,
+                {seeValuePawn(), seeValueKnight(), seeValueBishop(), seeValueRook(), seeValueQueen()}
+            );
+
+            return tables;
+        }();
+    } // namespace internal
+
+    inline constexpr const SeeValueTable& g_seeValues = internal::kSeeTables.values;
+    inline constexpr const SeeOrderTable& g_seeOrderedPts = internal::kSeeTables.orderedPts;
+#endif
+
 #undef SP_TUNABLE_PARAM
 #undef SP_TUNABLE_PARAM_CALLBACK
 #undef SP_TUNABLE_ASSERTS
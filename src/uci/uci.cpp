@@ -26,8 +26,10 @@
 #include <vector>
 
 #include "../../3rdparty/pyrrhic/tbprobe.h"
+#include "../attacks/bench.h"
 #include "../bench.h"
 #include "../eval/eval.h"
+#include "../eval/evalbench.h"
 #include "../limit.h"
 #include "../movegen.h"
 #include "../opts.h"
@@ -75,6 +77,29 @@ namespace stormphrax {
         }
 #endif
 
+        // [depth] [threads] [hash MiB], threads default to the Threads option
+        bool parsePerftArgs(std::span<const std::string_view> args, u32& depth, u32& threads, usize& hashMib) {
+            threads = static_cast<u32>(g_opts.threads);
+            hashMib = kDefaultPerftHashMib;
+
+            if (args.size() > 0 && !util::tryParse(depth, args[0])) {
+                eprintln("invalid depth {}", args[0]);
+                return false;
+            }
+
+            if (args.size() > 1 && (!util::tryParse(threads, args[1]) || threads == 0)) {
+                eprintln("invalid thread count {}", args[1]);
+                return false;
+            }
+
+            if (args.size() > 2 && !util::tryParse(hashMib, args[2])) {
+                eprintln("invalid hash size {}", args[2]);
+                return false;
+            }
+
+            return true;
+        }
+
         class UciHandler {
         public:
             UciHandler();
@@ -103,7 +128,13 @@ namespace stormphrax {
             void handleMoves();
             void handlePerft(std::span<const std::string_view> args);
             void handleSplitperft(std::span<const std::string_view> args);
+            void handlePerftsuite(std::span<const std::string_view> args);
+            void handleMakebench(std::span<const std::string_view> args);
             void handleBench(std::span<const std::string_view> args);
+            void handleEvalbench(std::span<const std::string_view> args);
+            void handleAttackbench();
+            void handleTimerbench();
+            void handleSearchstats();
             void handleProbeWdl();
             void handleWait();
             void handleMove(std::span<const std::string_view> args);
@@ -155,7 +186,21 @@ namespace stormphrax {
             registerSpinOption("Hash", nullptr, kDefaultTtSizeMib, kTtSizeMibRange, [&](i32 newHash) {
                 m_searcher.setTtSize(newHash);
             });
-            registerButtonOption("ClearHash", [&] { m_searcher.newGame(); });
+            registerButtonOption("ClearHash", [&] { handleUcinewgame(); });
+            registerSpinOption(
+                "CorrhistSizeLog2",
+                nullptr,
+                kDefaultCorrhistSizeLog2,
+                kCorrhistSizeLog2Range,
+                [&](i32 newSizeLog2) { m_searcher.setCorrhistSize(newSizeLog2); }
+            );
+            registerSpinOption(
+                "CorrhistShards",
+                nullptr,
+                kDefaultCorrhistShards,
+                kCorrhistShardsRange,
+                [&](i32 newShards) { m_searcher.setCorrhistShards(newShards); }
+            );
             registerSpinOption("Threads", &opts.threads, s_defaultOpts.threads, kThreadCountRange, [&](i32 newThreads) {
                 m_searcher.setThreads(newThreads);
             });
@@ -177,6 +222,12 @@ namespace stormphrax {
                 println("info string Note: EnableWeirdTCs is deprecated, and will be removed in a future release.");
             });
             registerCheckOption("Minimal", &opts.minimal, s_defaultOpts.minimal);
+            registerSpinOption(
+                "RefreshTableSize",
+                &opts.refreshTableSize,
+                s_defaultOpts.refreshTableSize,
+                kRefreshTableSizeRange
+            );
             registerStringOption("SyzygyPath", nullptr, "<empty>", [&](std::string_view value) {
                 if (value == "<empty>") {
                     opts.syzygyEnabled = false;
@@ -203,6 +254,9 @@ namespace stormphrax {
                 search::kSyzygyProbeLimitRange
             );
             registerCheckOption("SyzygyProbeRootOnly", &opts.syzygyProbeRootOnly, s_defaultOpts.syzygyProbeRootOnly);
+            registerStringOption("IterationLog", nullptr, "<empty>", [&](std::string_view value) {
+                m_searcher.setIterationLog(value == "<empty>" ? "" : value);
+            });
         }
 
         UciHandler::~UciHandler() {
@@ -282,8 +336,20 @@ namespace stormphrax {
                 handlePerft(args);
             } else if (command == "splitperft") {
                 handleSplitperft(args);
+            } else if (command == "perftsuite") {
+                handlePerftsuite(args);
+            } else if (command == "makebench") {
+                handleMakebench(args);
             } else if (command == "bench") {
                 handleBench(args);
+            } else if (command == "attackbench") {
+                handleAttackbench();
+            } else if (command == "timerbench") {
+                handleTimerbench();
+            } else if (command == "searchstats") {
+                handleSearchstats();
+            } else if (command == "evalbench") {
+                handleEvalbench(args);
             } else if (command == "probewdl") {
                 handleProbeWdl();
             } else if (command == "wait") {
@@ -828,28 +894,49 @@ namespace stormphrax {
 
         void UciHandler::handlePerft(std::span<const std::string_view> args) {
             u32 depth = 6;
+            u32 threads;
+            usize hashMib;
 
-            if (!args.empty()) {
-                if (!util::tryParse(depth, args[0])) {
-                    eprintln("invalid depth {}", args[0]);
-                    return;
-                }
+            if (!parsePerftArgs(args, depth, threads, hashMib)) {
+                return;
             }
 
-            perft(m_pos, static_cast<i32>(depth));
+            perft(m_pos, static_cast<i32>(depth), threads, hashMib);
         }
 
         void UciHandler::handleSplitperft(std::span<const std::string_view> args) {
             u32 depth = 6;
+            u32 threads;
+            usize hashMib;
 
-            if (!args.empty()) {
-                if (!util::tryParse(depth, args[0])) {
-                    eprintln("invalid depth {}", args[0]);
-                    return;
-                }
+            if (!parsePerftArgs(args, depth, threads, hashMib)) {
+                return;
             }
 
-            splitPerft(m_pos, static_cast<i32>(depth));
+            splitPerft(m_pos, static_cast<i32>(depth), threads, hashMib);
+        }
+
+        void UciHandler::handlePerftsuite(std::span<const std::string_view> args) {
+            u32 depth = 5;
+            u32 threads;
+            usize hashMib;
+
+            if (!parsePerftArgs(args, depth, threads, hashMib)) {
+                return;
+            }
+
+            perftSuite(static_cast<i32>(depth), threads, hashMib);
+        }
+
+        void UciHandler::handleMakebench(std::span<const std::string_view> args) {
+            u32 depth = 4;
+
+            if (args.size() > 0 && !util::tryParse(depth, args[0])) {
+                eprintln("invalid depth {}", args[0]);
+                return;
+            }
+
+            makeUnmakeBench(static_cast<i32>(depth));
         }
 
         void UciHandler::handleBench(std::span<const std::string_view> args) {
@@ -888,6 +975,121 @@ namespace stormphrax {
             m_quit = true;
         }
 
+        void UciHandler::handleEvalbench(std::span<const std::string_view> args) {
+            if (m_searcher.searching()) {
+                eprintln("already searching");
+                return;
+            }
+
+            const auto parseDepth = [](std::span<const std::string_view> args,
+                                       i32 defaultDepth = eval::bench::kDefaultTrajectoryDepth) -> std::optional<i32> {
+                if (args.empty()) {
+                    return defaultDepth;
+                }
+
+                if (const auto depth = util::tryParse<u32>(args[0])) {
+                    return static_cast<i32>(*depth);
+                }
+
+                eprintln("invalid depth {}", args[0]);
+                return {};
+            };
+
+            if (!args.empty() && args[0] == "record") {
+                if (args.size() < 2) {
+                    eprintln("Missing trajectory file");
+                    return;
+                }
+
+                const auto depth = parseDepth(args.subspan(2));
+
+                if (!depth) {
+                    return;
+                }
+
+                const auto trajectories = eval::bench::generateTrajectories(*depth);
+
+                if (eval::bench::saveTrajectories(std::string{args[1]}, trajectories)) {
+                    println("Wrote {} trajectories to {}", trajectories.size(), args[1]);
+                }
+            } else if (!args.empty() && args[0] == "activations") {
+                if (args.size() < 2) {
+                    eprintln("Missing output file");
+                    return;
+                }
+
+                std::vector<eval::bench::Trajectory> trajectories{};
+
+                if (args.size() < 3) {
+                    trajectories = eval::bench::generateTrajectories();
+                } else {
+                    const auto fens = eval::bench::loadDataset(std::string{args[2]});
+
+                    if (!fens) {
+                        return;
+                    }
+
+                    const auto depth = parseDepth(args.subspan(3), eval::bench::kDefaultDatasetDepth);
+
+                    if (!depth) {
+                        return;
+                    }
+
+                    trajectories = eval::bench::generateTrajectories(*fens, *depth);
+                }
+
+                if (!eval::bench::dumpActivations(trajectories, std::string{args[1]})) {
+                    return;
+                }
+            } else if (!args.empty() && args[0] == "threats") {
+                if (args.size() < 2) {
+                    eval::bench::runThreats(eval::bench::generateTrajectories());
+                } else if (const auto trajectories = eval::bench::loadTrajectories(std::string{args[1]})) {
+                    eval::bench::runThreats(*trajectories);
+                }
+            } else if (!args.empty() && args[0] == "replay") {
+                if (args.size() < 2) {
+                    eprintln("Missing trajectory file");
+                    return;
+                }
+
+                if (const auto trajectories = eval::bench::loadTrajectories(std::string{args[1]})) {
+                    eval::bench::run(*trajectories);
+                }
+            } else {
+                const auto depth = parseDepth(args);
+
+                if (!depth) {
+                    return;
+                }
+
+                eval::bench::run(eval::bench::generateTrajectories(*depth));
+            }
+
+            m_quit = true;
+        }
+
+        void UciHandler::handleAttackbench() {
+            attacks::bench::run();
+        }
+
+        void UciHandler::handleTimerbench() {
+            util::runTimerBench();
+        }
+
+        void UciHandler::handleSearchstats() {
+#ifdef SP_SEARCH_STATS
+            if (m_searcher.searching()) {
+                eprintln("still searching");
+                return;
+            }
+
+            m_searcher.searchStats().print();
+#else
+            eprintln("Search statistics not compiled in, build with SEARCH_STATS=on");
+#endif
+        }
+
         void UciHandler::handleProbeWdl() {
             if (!m_tbInitialized || !g_opts.syzygyEnabled) {
                 eprintln("no TBs loaded");
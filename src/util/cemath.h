@@ -38,6 +38,40 @@ namespace stormphrax::util {
         return (a + b - 1) / b;
     }
 
+    // Natural log usable in constant expressions, as std::log is not constexpr until C++26.
+    // Can be an ulp off std::log, so tables generated with it should use it at runtime too
+    [[nodiscard]] constexpr f64 ln(f64 x) {
+        constexpr f64 kLn2 = 0.693147180559945309417232121458176568;
+        constexpr f64 kSqrt2 = 1.41421356237309504880168872420969808;
+
+        // x = m * 2^exponent, m in [sqrt(2)/2, sqrt(2)]
+        i32 exponent = 0;
+
+        while (x > kSqrt2) {
+            x /= 2.0;
+            ++exponent;
+        }
+
+        while (x < kSqrt2 / 2.0) {
+            x *= 2.0;
+            --exponent;
+        }
+
+        // ln(m) = 2 * atanh((m - 1) / (m + 1))
+        const auto s = (x - 1.0) / (x + 1.0);
+        const auto s2 = s * s;
+
+        f64 term = s;
+        f64 sum = 0.0;
+
+        for (i32 k = 1; k < 64; k += 2) {
+            sum += term / static_cast<f64>(k);
+            term *= s2;
+        }
+
+        return 2.0 * sum + static_cast<f64>(exponent) * kLn2;
+    }
+
     template <std::unsigned_integral auto kBlock>
     [[nodiscard]] inline decltype(kBlock) pad(decltype(kBlock) v) {
         return ceilDiv(v, kBlock) * kBlock;
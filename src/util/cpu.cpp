@@ -0,0 +1,85 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cpu.h"
+
+#include "../arch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+#endif
+
+namespace stormphrax::util::cpu {
+    std::vector<std::string_view> missingBuildFeatures() {
+        std::vector<std::string_view> missing{};
+
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+
+    // __builtin_cpu_supports requires a string literal
+    #define SP_CHECK_FEATURE(Feature) \
+        do { \
+            if (!__builtin_cpu_supports(Feature)) { \
+                missing.emplace_back(Feature); \
+            } \
+        } while (false)
+
+    #if SP_HAS_AVX2
+        SP_CHECK_FEATURE("avx2");
+    #endif
+    #if SP_HAS_BMI2
+        SP_CHECK_FEATURE("bmi2");
+    #endif
+    #if SP_HAS_AVX512
+        SP_CHECK_FEATURE("avx512f");
+        SP_CHECK_FEATURE("avx512bw");
+    #endif
+    #if SP_HAS_VNNI512
+        SP_CHECK_FEATURE("avx512vnni");
+    #endif
+    #if SP_HAS_VBMI
+        SP_CHECK_FEATURE("avx512vbmi");
+    #endif
+    #if SP_HAS_VBMI2
+        SP_CHECK_FEATURE("avx512vbmi2");
+    #endif
+    #if SP_HAS_VNNI256
+        SP_CHECK_FEATURE("avxvnni");
+    #endif
+
+    #undef SP_CHECK_FEATURE
+#endif
+
+        return missing;
+    }
+
+    bool hasInvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+        u32 eax{}, ebx{}, ecx{}, edx{};
+
+        // advanced power management leaf, invariant TSC is EDX bit 8
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+
+        return (edx & (1U << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+} // namespace stormphrax::util::cpu
@@ -0,0 +1,34 @@
+/*
+ * Stormphrax, a UCI chess engine
+ * Copyright (C) 2026 Ciekce
+ *
+ * Stormphrax is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Stormphrax is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Stormphrax. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../types.h"
+
+#include <string_view>
+#include <vector>
+
+namespace stormphrax::util::cpu {
+    // Returns the instruction set extensions this binary was compiled
+    // to require that the current CPU does not report support for
+    [[nodiscard]] std::vector<std::string_view> missingBuildFeatures();
+
+    // Whether the CPU's timestamp counter ticks at a constant rate regardless of
+    // frequency scaling and sleep states. Always false on non-x86 platforms
+    [[nodiscard]] bool hasInvariantTsc();
+} // namespace stormphrax::util::cpu
@@ -32,14 +32,18 @@
 
 namespace stormphrax::util::signal {
     namespace {
-        CtrlCHandler s_handler{};
-    }
+        // constructed on first use, see timer.cpp
+        [[nodiscard]] CtrlCHandler& handler() {
+            static CtrlCHandler s_handler{};
+            return s_handler;
+        }
+    } // namespace
 
-    void setCtrlCHandler(CtrlCHandler handler) {
-        assert(!s_handler);
-        assert(handler);
+    void setCtrlCHandler(CtrlCHandler newHandler) {
+        assert(!handler());
+        assert(newHandler);
 
-        s_handler = std::move(handler);
+        handler() = std::move(newHandler);
 
 #ifdef _WIN32
         const auto result = SetConsoleCtrlHandler(
@@ -48,7 +52,7 @@ namespace stormphrax::util::signal {
                     return FALSE;
                 }
 
-                s_handler();
+                handler()();
                 return TRUE;
             },
             TRUE
@@ -63,7 +67,7 @@ namespace stormphrax::util::signal {
         action.sa_flags = SA_RESTART;
         action.sa_handler = [](int signal) {
             SP_UNUSED(signal);
-            s_handler();
+            handler()();
         };
 
         if (sigaction(SIGINT, &action, nullptr)) {
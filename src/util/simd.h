@@ -70,6 +70,11 @@ namespace stormphrax::util::simd {
         using Type = VectorI32;
     };
 
+    template <>
+    struct VectorImpl<u64> {
+        using Type = VectorU64;
+    };
+
     template <typename T>
     using Vector = typename VectorImpl<T>::Type;
     template <typename T>
@@ -201,6 +206,18 @@ namespace stormphrax::util::simd {
         return impl::loadI32(ptr);
     }
 
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto set1<u64>(u64 v) {
+        return impl::set1U64(v);
+    }
+
+    template <typename T>
+    SP_ALWAYS_INLINE_NDEBUG inline auto loadUnaligned(const void* ptr) = delete;
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto loadUnaligned<u64>(const void* ptr) {
+        return impl::loadUnalignedU64(ptr);
+    }
+
     SP_ALWAYS_INLINE_NDEBUG inline Vector<i16> widenLoadI8ToI16(const void* ptr) {
         return impl::widenLoadI8ToI16(ptr);
     }
@@ -286,6 +303,21 @@ namespace stormphrax::util::simd {
         return impl::shiftLeftMulHiI16(a, b, shift);
     }
 
+    template <typename T>
+    SP_ALWAYS_INLINE_NDEBUG inline auto abs(Vector<T> v) = delete;
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto abs<i16>(Vector<i16> v) {
+        return impl::absI16(v);
+    }
+
+    // treats both operands as unsigned
+    template <typename T>
+    SP_ALWAYS_INLINE_NDEBUG inline auto mulHiUnsigned(Vector<T> a, Vector<T> b) = delete;
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto mulHiUnsigned<i16>(Vector<i16> a, Vector<i16> b) {
+        return impl::mulHiUnsignedI16(a, b);
+    }
+
     template <typename T>
     SP_ALWAYS_INLINE_NDEBUG inline auto packUnsigned(Vector<T> a, Vector<T> b) = delete;
     template <>
@@ -311,6 +343,13 @@ namespace stormphrax::util::simd {
         return impl::hsumI32(v);
     }
 
+    template <typename T>
+    SP_ALWAYS_INLINE_NDEBUG inline auto hmax(Vector<T> v) = delete;
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto hmax<i32>(Vector<i32> v) {
+        return impl::hmaxI32(v);
+    }
+
     template <typename T>
     SP_ALWAYS_INLINE_NDEBUG inline auto dpbusd(Vector<T> sum, Vector<u8> u, Vector<i8> i) = delete;
     template <>
@@ -325,6 +364,17 @@ namespace stormphrax::util::simd {
         return impl::nonzeroMaskU8(v);
     }
 
+    template <typename T>
+    SP_ALWAYS_INLINE_NDEBUG inline auto equalMask(Vector<T> a, Vector<T> b) = delete;
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto equalMask<i32>(Vector<i32> a, Vector<i32> b) {
+        return impl::equalMaskI32(a, b);
+    }
+    template <>
+    SP_ALWAYS_INLINE_NDEBUG inline auto equalMask<u64>(Vector<u64> a, Vector<u64> b) {
+        return impl::equalMaskU64(a, b);
+    }
+
 #undef SP_SIMD_OP_0
 #undef SP_SIMD_OP_1_VALUE
 #undef SP_SIMD_OP_2_VECTORS
@@ -35,6 +35,8 @@ namespace stormphrax::util::simd {
     using VectorI16 = __m256i;
     using VectorI32 = __m256i;
 
+    using VectorU64 = __m256i;
+
     constexpr std::uintptr_t kAlignment = sizeof(__m256i);
 
     constexpr bool kPackNonSequential = true;
@@ -181,6 +183,15 @@ namespace stormphrax::util::simd {
             return _mm256_mulhi_epi16(shifted, b);
         }
 
+        SP_ALWAYS_INLINE_NDEBUG inline VectorI16 absI16(VectorI16 v) {
+            return _mm256_abs_epi16(v);
+        }
+
+        // treats both operands as unsigned
+        SP_ALWAYS_INLINE_NDEBUG inline VectorI16 mulHiUnsignedI16(VectorI16 a, VectorI16 b) {
+            return _mm256_mulhi_epu16(a, b);
+        }
+
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 mulAddAdjI16(VectorI16 a, VectorI16 b) {
             return _mm256_madd_epi16(a, b);
         }
@@ -260,9 +271,28 @@ namespace stormphrax::util::simd {
             return _mm_cvtsi128_si32(sum32);
         }
 
+        SP_ALWAYS_INLINE_NDEBUG inline i32 hmaxI32(VectorI32 v) {
+            const auto high128 = _mm256_extracti128_si256(v, 1);
+            const auto low128 = _mm256_castsi256_si128(v);
+
+            const auto max128 = _mm_max_epi32(high128, low128);
+
+            const auto high64 = _mm_unpackhi_epi64(max128, max128);
+            const auto max64 = _mm_max_epi32(max128, high64);
+
+            const auto high32 = _mm_shuffle_epi32(max64, _MM_SHUFFLE(2, 3, 0, 1));
+            const auto max32 = _mm_max_epi32(max64, high32);
+
+            return _mm_cvtsi128_si32(max32);
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline u32 equalMaskI32(VectorI32 a, VectorI32 b) {
+            return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+        }
+
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 dpbusdI32(VectorI32 sum, VectorU8 u, VectorI8 i) {
     #if SP_HAS_VNNI256
-            return _mm256_dpbusd_epi32(sum, u, i);
+            return _mm256_dpbusd_avx_epi32(sum, u, i);
     #else
             const auto p = _mm256_maddubs_epi16(u, i);
             const auto w = _mm256_madd_epi16(p, _mm256_set1_epi16(1));
@@ -278,12 +308,26 @@ namespace stormphrax::util::simd {
         // Depends on addI32
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 mulAddAdjAccI16(VectorI32 sum, VectorI16 a, VectorI16 b) {
     #if SP_HAS_VNNI256
-            return _mm256_dpwssd_epi32(sum, a, b);
+            return _mm256_dpwssd_avx_epi32(sum, a, b);
     #else
             const auto products = mulAddAdjI16(a, b);
             return addI32(sum, products);
     #endif
         }
+
+        // ================================ u64 ================================
+
+        SP_ALWAYS_INLINE_NDEBUG inline VectorU64 set1U64(u64 v) {
+            return _mm256_set1_epi64x(static_cast<i64>(v));
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline VectorU64 loadUnalignedU64(const void* ptr) {
+            return _mm256_loadu_si256(static_cast<const VectorU64*>(ptr));
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline u32 equalMaskU64(VectorU64 a, VectorU64 b) {
+            return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+        }
     } // namespace impl
 } // namespace stormphrax::util::simd
 
@@ -35,6 +35,8 @@ namespace stormphrax::util::simd {
     using VectorI16 = __m512i;
     using VectorI32 = __m512i;
 
+    using VectorU64 = __m512i;
+
     constexpr std::uintptr_t kAlignment = sizeof(__m512i);
 
     constexpr bool kPackNonSequential = true;
@@ -181,6 +183,15 @@ namespace stormphrax::util::simd {
             return _mm512_mulhi_epi16(shifted, b);
         }
 
+        SP_ALWAYS_INLINE_NDEBUG inline VectorI16 absI16(VectorI16 v) {
+            return _mm512_abs_epi16(v);
+        }
+
+        // treats both operands as unsigned
+        SP_ALWAYS_INLINE_NDEBUG inline VectorI16 mulHiUnsignedI16(VectorI16 a, VectorI16 b) {
+            return _mm512_mulhi_epu16(a, b);
+        }
+
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 mulAddAdjI16(VectorI16 a, VectorI16 b) {
             return _mm512_madd_epi16(a, b);
         }
@@ -251,6 +262,14 @@ namespace stormphrax::util::simd {
             return _mm512_reduce_add_epi32(v);
         }
 
+        SP_ALWAYS_INLINE_NDEBUG inline i32 hmaxI32(VectorI32 v) {
+            return _mm512_reduce_max_epi32(v);
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline u32 equalMaskI32(VectorI32 a, VectorI32 b) {
+            return _mm512_cmpeq_epi32_mask(a, b);
+        }
+
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 dpbusdI32(VectorI32 sum, VectorU8 u, VectorI8 i) {
     #if SP_HAS_VNNI512
             return _mm512_dpbusd_epi32(sum, u, i);
@@ -274,6 +293,20 @@ namespace stormphrax::util::simd {
             return addI32(sum, products);
     #endif
         }
+
+        // ================================ u64 ================================
+
+        SP_ALWAYS_INLINE_NDEBUG inline VectorU64 set1U64(u64 v) {
+            return _mm512_set1_epi64(static_cast<i64>(v));
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline VectorU64 loadUnalignedU64(const void* ptr) {
+            return _mm512_loadu_si512(ptr);
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline u32 equalMaskU64(VectorU64 a, VectorU64 b) {
+            return _mm512_cmpeq_epi64_mask(a, b);
+        }
     } // namespace impl
 } // namespace stormphrax::util::simd
 
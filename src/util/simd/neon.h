@@ -35,6 +35,8 @@ namespace stormphrax::util::simd {
     using VectorI16 = int16x8_t;
     using VectorI32 = int32x4_t;
 
+    using VectorU64 = uint64x2_t;
+
     constexpr std::uintptr_t kAlignment = sizeof(int16x8_t);
 
     constexpr bool kPackNonSequential = false;
@@ -182,6 +184,19 @@ namespace stormphrax::util::simd {
             return vqdmulhq_s16(shifted, b);
         }
 
+        SP_ALWAYS_INLINE_NDEBUG inline VectorI16 absI16(VectorI16 v) {
+            return vabsq_s16(v);
+        }
+
+        // treats both operands as unsigned
+        SP_ALWAYS_INLINE_NDEBUG inline VectorI16 mulHiUnsignedI16(VectorI16 a, VectorI16 b) {
+            const auto ua = vreinterpretq_u16_s16(a);
+            const auto ub = vreinterpretq_u16_s16(b);
+            const auto low = vreinterpretq_u16_u32(vmull_u16(vget_low_u16(ua), vget_low_u16(ub)));
+            const auto high = vreinterpretq_u16_u32(vmull_high_u16(ua, ub));
+            return vreinterpretq_s16_u16(vuzp2q_u16(low, high));
+        }
+
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 mulAddAdjI16(VectorI16 a, VectorI16 b) {
             const auto low = vmull_s16(vget_low_s16(a), vget_low_s16(b));
             const auto high = vmull_high_s16(a, b);
@@ -256,6 +271,15 @@ namespace stormphrax::util::simd {
             return vaddvq_s32(v);
         }
 
+        SP_ALWAYS_INLINE_NDEBUG inline i32 hmaxI32(VectorI32 v) {
+            return vmaxvq_s32(v);
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline u32 equalMaskI32(VectorI32 a, VectorI32 b) {
+            alignas(kAlignment) static constexpr std::array<u32, 4> kMask = {1, 2, 4, 8};
+            return vaddvq_u32(vandq_u32(vceqq_s32(a, b), vld1q_u32(kMask.data())));
+        }
+
         SP_ALWAYS_INLINE_NDEBUG inline VectorI32 dpbusdI32(VectorI32 sum, VectorU8 u, VectorI8 i) {
             const auto i0 = vreinterpretq_u8_s8(u);
 
@@ -279,6 +303,21 @@ namespace stormphrax::util::simd {
             const auto products = mulAddAdjI16(a, b);
             return addI32(sum, products);
         }
+
+        // ================================ u64 ================================
+
+        SP_ALWAYS_INLINE_NDEBUG inline VectorU64 set1U64(u64 v) {
+            return vdupq_n_u64(v);
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline VectorU64 loadUnalignedU64(const void* ptr) {
+            return vld1q_u64(static_cast<const u64*>(ptr));
+        }
+
+        SP_ALWAYS_INLINE_NDEBUG inline u32 equalMaskU64(VectorU64 a, VectorU64 b) {
+            const auto eq = vceqq_u64(a, b);
+            return static_cast<u32>((vgetq_lane_u64(eq, 0) & 1) | (vgetq_lane_u64(eq, 1) & 2));
+        }
     } // namespace impl
 } // namespace stormphrax::util::simd
 
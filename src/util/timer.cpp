@@ -18,21 +18,66 @@
 
 #include "timer.h"
 
+#include <atomic>
+#include <chrono>
+#include <string_view>
+#include <thread>
+
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN
     #include <Windows.h>
 #else // posix
     #include <time.h>
+
+    #if defined(__x86_64__)
+        // Read the TSC directly where it runs at a constant rate, rather than going through clock_gettime
+        #define SP_TSC_TIMER 1
+        #include <x86intrin.h>
+
+        #include "cpu.h"
+    #endif
 #endif
 
 namespace stormphrax::util {
     namespace {
+#ifndef _WIN32
+        [[nodiscard]] inline f64 monotonicTime() {
+            struct timespec time{};
+            clock_gettime(CLOCK_MONOTONIC, &time);
+
+            return static_cast<f64>(time.tv_sec) + static_cast<f64>(time.tv_nsec) / 1000000000.0;
+        }
+#endif
+
+#if SP_TSC_TIMER
+        // The TSC is calibrated against the monotonic clock once this much time has passed since startup,
+        // which avoids stalling startup to calibrate and keeps the error from the calibration negligible
+        constexpr f64 kTscCalibrationTime = 0.1;
+#endif
+
         class Timer {
         public:
             Timer();
 
             [[nodiscard]] f64 time() const;
 
+            [[nodiscard]] std::string_view backend() const;
+
+#if SP_TSC_TIMER
+            [[nodiscard]] inline bool tscUsable() const {
+                return m_tscUsable;
+            }
+
+            // 0 if not yet calibrated
+            [[nodiscard]] inline f64 secondsPerTick() const {
+                return m_secondsPerTick.load(std::memory_order::relaxed);
+            }
+
+            [[nodiscard]] inline f64 tscTime() const {
+                return static_cast<f64>(__rdtsc() - m_initTicks) * secondsPerTick();
+            }
+#endif
+
         private:
 #ifdef _WIN32
             u64 m_initTime{};
@@ -40,6 +85,13 @@ namespace stormphrax::util {
 #else
             f64 m_initTime;
 #endif
+
+#if SP_TSC_TIMER
+            bool m_tscUsable{};
+            u64 m_initTicks{};
+
+            mutable std::atomic<f64> m_secondsPerTick{};
+#endif
         };
 
 #ifdef _WIN32
@@ -60,30 +112,135 @@ namespace stormphrax::util {
 
             return static_cast<f64>(time.QuadPart - m_initTime) / m_frequency;
         }
+
+        std::string_view Timer::backend() const {
+            return "QueryPerformanceCounter";
+        }
 #else
         Timer::Timer() {
-            struct timespec time;
-            clock_gettime(CLOCK_MONOTONIC, &time);
+            m_initTime = monotonicTime();
 
-            m_initTime = static_cast<f64>(time.tv_sec) + static_cast<f64>(time.tv_nsec) / 1000000000.0;
+    #if SP_TSC_TIMER
+            m_tscUsable = cpu::hasInvariantTsc();
+            m_initTicks = __rdtsc();
+    #endif
         }
 
         f64 Timer::time() const {
-            struct timespec time{};
-            clock_gettime(CLOCK_MONOTONIC, &time);
+    #if SP_TSC_TIMER
+            if (secondsPerTick() > 0.0) {
+                return tscTime();
+            }
+    #endif
+
+            const auto time = monotonicTime() - m_initTime;
+
+    #if SP_TSC_TIMER
+            if (m_tscUsable && time >= kTscCalibrationTime) {
+                // Only the first thread here calibrates, so the scale never changes once set
+                const auto ticks = __rdtsc() - m_initTicks;
+
+                f64 uncalibrated = 0.0;
+                m_secondsPerTick.compare_exchange_strong(
+                    uncalibrated,
+                    time / static_cast<f64>(ticks),
+                    std::memory_order::relaxed
+                );
+            }
+    #endif
+
+            return time;
+        }
 
-            return (static_cast<f64>(time.tv_sec) + static_cast<f64>(time.tv_nsec) / 1000000000.0) - m_initTime;
+        std::string_view Timer::backend() const {
+    #if SP_TSC_TIMER
+            if (m_tscUsable) {
+                return secondsPerTick() > 0.0 ? "TSC" : "TSC (uncalibrated, currently CLOCK_MONOTONIC)";
+            }
+    #endif
+
+            return "CLOCK_MONOTONIC";
         }
 #endif
 
-        const Timer s_timer{};
+        // Constructed on first use rather than during static init, as the variant objects of a multi
+        // build are compiled for instruction sets that the dispatcher has not yet checked for
+        [[nodiscard]] const Timer& timer() {
+            static const Timer s_timer{};
+            return s_timer;
+        }
+
+        template <typename F>
+        f64 measureCallNs(F&& f) {
+            constexpr usize kIterations = 10000000;
+
+            f64 sink{};
+
+            const auto start = timer().time();
+
+            for (usize i = 0; i < kIterations; ++i) {
+                sink += f();
+            }
+
+            const auto time = timer().time() - start;
+
+            // keep the calls from being optimised out
+            if (sink == -1.0) {
+                println("{}", sink);
+            }
+
+            return time * 1000000000.0 / static_cast<f64>(kIterations);
+        }
     } // namespace
 
     f64 Instant::elapsed() const {
-        return s_timer.time() - m_time;
+        return timer().time() - m_time;
     }
 
     Instant Instant::now() {
-        return Instant{s_timer.time()};
+        return Instant{timer().time()};
+    }
+
+    void runTimerBench() {
+#if SP_TSC_TIMER
+        // make sure the TSC is calibrated before comparing
+        if (timer().tscUsable()) {
+            while (timer().secondsPerTick() == 0.0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+                [[maybe_unused]] const auto time = timer().time();
+            }
+        }
+#endif
+
+        println("backend: {}", timer().backend());
+
+#ifdef _WIN32
+        println("QueryPerformanceCounter: {:.2f} ns/call", measureCallNs([] { return timer().time(); }));
+#else
+        const auto monotonicStart = monotonicTime();
+        const auto instantStart = Instant::now();
+
+        println("clock_gettime(CLOCK_MONOTONIC): {:.2f} ns/call", measureCallNs([] { return monotonicTime(); }));
+
+    #if SP_TSC_TIMER
+        if (timer().tscUsable()) {
+            println("TSC frequency: {:.2f} MHz", 1.0 / timer().secondsPerTick() / 1000000.0);
+            println("rdtsc: {:.2f} ns/call", measureCallNs([] { return timer().tscTime(); }));
+        } else {
+            println("TSC not invariant, not used");
+        }
+    #endif
+
+        println("Instant::now(): {:.2f} ns/call", measureCallNs([] { return Instant::now().elapsed(); }) / 2.0);
+
+        const auto monotonicElapsed = monotonicTime() - monotonicStart;
+        const auto instantElapsed = instantStart.elapsed();
+
+        println(
+            "Instant drift against CLOCK_MONOTONIC over {:.2f} s: {:.2f} ppm",
+            monotonicElapsed,
+            (instantElapsed - monotonicElapsed) / monotonicElapsed * 1000000.0
+        );
+#endif
     }
 } // namespace stormphrax::util
@@ -47,4 +47,7 @@ namespace stormphrax::util {
 
         f64 m_time;
     };
+
+    // Compares the cost of reading each clock available on this machine
+    void runTimerBench();
 } // namespace stormphrax::util